@@ -0,0 +1,163 @@
+/**
+ * @file    cpudispatch.cpp
+ * @brief   Chooses the widest vector instruction set that the arithmetic
+ *          kernels behind Poly may use on the machine they run on. The CPU
+ *          is probed the first time a kernel asks, so one binary runs the
+ *          AVX-512 kernels where they are supported and falls back to AVX2,
+ *          SSE4.1 or portable code elsewhere. Setting the environment
+ *          variable POLY_SIMD to portable, sse4, avx2 or avx512 before the
+ *          program starts forces that level instead, for benchmarking; a
+ *          level the CPU does not support is lowered to one it does.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "cpudispatch.h"
+#include <cstdlib>
+#include <cstring>
+
+static const char *const LEVEL_NAMES[] = { "portable", "sse4", "avx2",
+                                           "avx512" };
+static const int LEVEL_COUNT = 4;
+
+/**----------------------------------------------------------------------------
+ * Asks the CPU which of the instruction sets it supports. The vector kernels
+ * are only built for x86 with GCC or Clang; anything else is portable.
+ * @pre None.
+ * @post None.
+ * @return The widest level this CPU can run.
+ */
+static SimdLevel probeCpu()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return SIMD_AVX512;
+    } // end if (__builtin_cpu_supports("avx512f"))
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SIMD_AVX2;
+    } // end if (__builtin_cpu_supports("avx2"))
+
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return SIMD_SSE4;
+    } // end if (__builtin_cpu_supports("sse4.1"))
+#endif
+
+    return SIMD_PORTABLE;
+} // end probeCpu()
+
+/**----------------------------------------------------------------------------
+ * Accessor for the widest supported level, probed on the first call.
+ * @pre None.
+ * @post None.
+ * @return The widest level this CPU can run.
+ */
+static SimdLevel supportedLevel()
+{
+    static const SimdLevel supported = probeCpu();
+
+    return supported;
+} // end supportedLevel()
+
+/**----------------------------------------------------------------------------
+ * Picks the starting level: the widest supported one, unless POLY_SIMD names
+ * another.
+ * @pre None.
+ * @post None.
+ * @return The level to use until setSimdLevel() is called.
+ */
+static SimdLevel initialLevel()
+{
+    const char *forced = getenv("POLY_SIMD");
+
+    if (forced != NULL)
+    {
+        for (int i = 0; i < LEVEL_COUNT; ++i)
+        {
+            if (strcmp(forced, LEVEL_NAMES[i]) == 0)
+            {
+                SimdLevel level = static_cast<SimdLevel>(i);
+
+                return level < supportedLevel() ? level : supportedLevel();
+            } // end if (strcmp(forced, LEVEL_NAMES[i]) == 0)
+        } // end for (int i = 0)
+    } // end if (forced != NULL)
+
+    return supportedLevel();
+} // end initialLevel()
+
+/**----------------------------------------------------------------------------
+ * Accessor for the variable holding the level in use, set up on the first
+ * call so that it is ready even for kernels run by static constructors.
+ * @pre None.
+ * @post None.
+ * @return A reference to the level in use.
+ */
+static SimdLevel& currentLevel()
+{
+    static SimdLevel level = initialLevel();
+
+    return level;
+} // end currentLevel()
+
+/**----------------------------------------------------------------------------
+ * Accessor for the level the kernels currently use. The first call probes the
+ * CPU and reads POLY_SIMD.
+ * @pre None.
+ * @post None.
+ * @return The level in use.
+ */
+SimdLevel getSimdLevel()
+{
+    return currentLevel();
+} // end getSimdLevel()
+
+/**----------------------------------------------------------------------------
+ * Accessor for the widest level the CPU supports.
+ * @pre None.
+ * @post None.
+ * @return The widest level whose instructions this CPU can run.
+ */
+SimdLevel getSupportedSimdLevel()
+{
+    return supportedLevel();
+} // end getSupportedSimdLevel()
+
+/**----------------------------------------------------------------------------
+ * Mutator to force the level the kernels use.
+ * @param level  The new level. A level the CPU does not support is lowered to
+ *               the widest one it does.
+ * @pre No kernel is running on another thread.
+ * @post Later kernel calls use the new level.
+ */
+void setSimdLevel(SimdLevel level)
+{
+    if (level < SIMD_PORTABLE)
+    {
+        level = SIMD_PORTABLE;
+    } // end if (level < SIMD_PORTABLE)
+
+    currentLevel() = level < supportedLevel() ? level : supportedLevel();
+} // end setSimdLevel(SimdLevel)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the name of a level, as accepted by POLY_SIMD.
+ * @param level  The level to name.
+ * @pre None.
+ * @post None.
+ * @return "portable", "sse4", "avx2" or "avx512".
+ */
+const char *getSimdLevelName(SimdLevel level)
+{
+    if (level < SIMD_PORTABLE || level >= LEVEL_COUNT)
+    {
+        return LEVEL_NAMES[SIMD_PORTABLE];
+    } // end if (level < SIMD_PORTABLE || level >= LEVEL_COUNT)
+
+    return LEVEL_NAMES[level];
+} // end getSimdLevelName(SimdLevel)
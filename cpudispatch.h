@@ -0,0 +1,62 @@
+/**
+ * @file    cpudispatch.h
+ * @brief   Chooses the widest vector instruction set that the arithmetic
+ *          kernels behind Poly may use on the machine they run on. The CPU
+ *          is probed the first time a kernel asks, so one binary runs the
+ *          AVX-512 kernels where they are supported and falls back to AVX2,
+ *          SSE4.1 or portable code elsewhere. Setting the environment
+ *          variable POLY_SIMD to portable, sse4, avx2 or avx512 before the
+ *          program starts forces that level instead, for benchmarking; a
+ *          level the CPU does not support is lowered to one it does.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _CPUDISPATCH_H
+#define	_CPUDISPATCH_H
+
+// instruction sets the kernels are built for, from narrowest to widest
+enum SimdLevel
+{
+    SIMD_PORTABLE,
+    SIMD_SSE4,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+/**----------------------------------------------------------------------------
+ * Accessor for the level the kernels currently use. The first call probes
+ * the CPU and reads POLY_SIMD.
+ * @pre None.
+ * @post None.
+ * @return The level in use.
+ */
+SimdLevel getSimdLevel();
+
+/**----------------------------------------------------------------------------
+ * Accessor for the widest level the CPU supports.
+ * @pre None.
+ * @post None.
+ * @return The widest level whose instructions this CPU can run.
+ */
+SimdLevel getSupportedSimdLevel();
+
+/**----------------------------------------------------------------------------
+ * Mutator to force the level the kernels use.
+ * @param level  The new level. A level the CPU does not support is lowered
+ *               to the widest one it does.
+ * @pre No kernel is running on another thread.
+ * @post Later kernel calls use the new level.
+ */
+void setSimdLevel(SimdLevel level);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the name of a level, as accepted by POLY_SIMD.
+ * @param level  The level to name.
+ * @pre None.
+ * @post None.
+ * @return "portable", "sse4", "avx2" or "avx512".
+ */
+const char *getSimdLevelName(SimdLevel level);
+
+#endif	/* _CPUDISPATCH_H */
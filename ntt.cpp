@@ -0,0 +1,622 @@
+/**
+ * @file    ntt.cpp
+ * @brief   Number-theoretic transform multiplication for the coefficient
+ *          arrays behind Poly. Both operands are transformed modulo three
+ *          primes of the form c * 2^k + 1, multiplied pointwise and
+ *          transformed back. The three residues of each coefficient are then
+ *          joined with the Chinese remainder theorem and reduced to 32 bits,
+ *          which gives exactly the wrapped-around result of the schoolbook
+ *          loop as long as the product has no more than NTT_MAX_LENGTH
+ *          coefficients. A square needs only one forward transform per
+ *          prime instead of two, and a truncated product recovers only the
+ *          coefficients asked for. Given a thread pool, each pass of the
+ *          transforms is cut into ranges run on its threads.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "ntt.h"
+#include "scratch.h"
+#include "threadpool.h"
+#include <cstddef>
+
+// NTT-friendly primes; 3 is a primitive root of each
+static const unsigned int PRIME1 = 998244353;   // 119 * 2^23 + 1
+static const unsigned int PRIME2 = 167772161;   // 5 * 2^25 + 1
+static const unsigned int PRIME3 = 469762049;   // 7 * 2^26 + 1
+static const unsigned int ROOT = 3;
+
+// length of the blocks that the narrow levels of a transform are done on one
+// at a time; 32 KB, which stays in a 32 KB L1 data cache
+static const int NTT_BLOCK = 8192;
+
+// fewest elements worth a task of their own in a pass over an array
+static const int PASS_GRAIN = 4096;
+
+// one pass over a transform array, cut into one range of elements per task;
+// each task reads the fields its pass needs
+struct NttPass
+{
+    unsigned int *data;         // the array
+    const unsigned int *other;  // the pointwise factor, or NULL
+    const int *source;          // the operand being loaded
+    int count;                  // elements of source
+    unsigned int *twiddle;      // powers of the root of unity
+    int len;                    // elements of data
+    int half;                   // half the butterfly width, or the block
+    unsigned int value;         // the root, or a constant factor
+    int tasks;
+};
+
+/**----------------------------------------------------------------------------
+ * Raises a number to a power modulo a prime.
+ * @param base  The number to raise.
+ * @param exp  The power to raise it to.
+ * @param mod  The modulus.
+ * @pre base is less than mod.
+ * @post None.
+ * @return base^exp mod mod.
+ */
+static unsigned int powMod(unsigned int base, unsigned long long exp,
+                           unsigned int mod)
+{
+    unsigned long long result = 1, square = base;
+
+    while (exp > 0)
+    {
+        if (exp & 1)
+        {
+            result = result * square % mod;
+        } // end if (exp & 1)
+
+        square = square * square % mod;
+        exp >>= 1;
+    } // end while (exp > 0)
+
+    return static_cast<unsigned int>(result);
+} // end powMod(unsigned int, unsigned long long, unsigned int)
+
+/**----------------------------------------------------------------------------
+ * Finds the range of elements one task of a pass works on.
+ * @param total  The number of elements in the pass.
+ * @param tasks  The number of tasks the pass is cut into.
+ * @param index  The task.
+ * @param lo  Receives the first element of the range.
+ * @param hi  Receives one past the last element of the range.
+ * @pre index is less than tasks.
+ * @post lo and hi are set; the ranges of all tasks cover the pass once.
+ */
+static void cutRange(int total, int tasks, int index, int& lo, int& hi)
+{
+    lo = static_cast<int>(static_cast<long long>(total) * index / tasks);
+    hi = static_cast<int>(static_cast<long long>(total) * (index + 1)
+                          / tasks);
+} // end cutRange(int, int, int, int&, int&)
+
+/**----------------------------------------------------------------------------
+ * Decides how many tasks a pass is cut into.
+ * @param workers  The pool the pass runs on, or NULL for the calling thread.
+ * @param total  The number of elements, or blocks, in the pass.
+ * @param grain  The fewest elements worth a task of their own.
+ * @pre None.
+ * @post None.
+ * @return One task per thread of workers, fewer if they would get less than
+ *         grain elements each; 1 without a pool.
+ */
+static int taskCount(const ThreadPool *workers, int total, int grain)
+{
+    int tasks = workers != NULL ? workers->size() : 1;
+
+    if (tasks > total / grain)
+    {
+        tasks = total / grain;
+    } // end if (tasks > total / grain)
+
+    return tasks > 1 ? tasks : 1;
+} // end taskCount(const ThreadPool*, int, int)
+
+/**----------------------------------------------------------------------------
+ * Runs the tasks of a pass on a pool, or the one task of a pass on the
+ * calling thread.
+ * @param workers  The pool, or NULL.
+ * @param tasks  The number of tasks; 1 if workers is NULL.
+ * @param task  The function to run.
+ * @param context  The pass.
+ * @pre None.
+ * @post Every task has returned.
+ */
+static void runPass(ThreadPool *workers, int tasks, ThreadPool::Task task,
+                    void *context)
+{
+    if (workers != NULL)
+    {
+        workers->run(tasks, task, context);
+    }
+    else
+    {
+        task(context, 0);
+    } // end if (workers != NULL)
+} // end runPass(ThreadPool*, int, ThreadPool::Task, void*)
+
+/**----------------------------------------------------------------------------
+ * One butterfly of a transform level: combines two elements with a power of
+ * the root of unity.
+ * @param low  The element of the lower half.
+ * @param high  The element of the upper half.
+ * @param twiddle  The power of the root.
+ * @pre All three are less than MOD.
+ * @post low and high hold their sum and difference, with high scaled by
+ *       twiddle first, both less than MOD.
+ */
+template <unsigned int MOD>
+static inline void butterfly(unsigned int& low, unsigned int& high,
+                             unsigned int twiddle)
+{
+    const unsigned int mod = MOD;
+    unsigned int u = low;
+    unsigned int v = static_cast<unsigned int>(
+            static_cast<unsigned long long>(high) * twiddle % mod);
+
+    low = u + v >= mod ? u + v - mod : u + v;
+    high = u >= v ? u - v : u + mod - v;
+} // end butterfly(unsigned int&, unsigned int&, unsigned int)
+
+/**----------------------------------------------------------------------------
+ * Task that loads one range of an operand into a transform array, reducing
+ * each coefficient and padding with 0.
+ * @param context  The NttPass; source, count, data and len are used.
+ * @param index  The range.
+ * @pre None.
+ * @post The range of data holds the reduced coefficients.
+ */
+template <unsigned int MOD>
+static void loadTask(void *context, int index)
+{
+    const NttPass& pass = *static_cast<NttPass*>(context);
+    int lo, hi;
+
+    cutRange(pass.len, pass.tasks, index, lo, hi);
+
+    for (int i = lo; i < hi; ++i)
+    {
+        pass.data[i] = i < pass.count
+                       ? static_cast<unsigned int>(pass.source[i]) % MOD : 0;
+    } // end for (int i = lo)
+} // end loadTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Task that applies the bit-reversal permutation to one range of indices.
+ * Each pair is swapped by the task that holds its lower index, so ranges
+ * never touch the same pair.
+ * @param context  The NttPass; data and len are used.
+ * @param index  The range.
+ * @pre None.
+ * @post Every element in the range has been swapped with its partner, if
+ *       that is higher.
+ */
+static void reverseTask(void *context, int index)
+{
+    const NttPass& pass = *static_cast<NttPass*>(context);
+    int lo, hi;
+
+    cutRange(pass.len, pass.tasks, index, lo, hi);
+    lo = lo > 1 ? lo : 1;
+
+    // j is the reversal of i - 1 on entry to each step
+    int j = 0;
+
+    for (int bit = 1, rest = lo - 1; bit < pass.len; bit <<= 1, rest >>= 1)
+    {
+        j = j << 1 | (rest & 1);
+    } // end for (int bit = 1, rest = lo - 1; bit < pass.len)
+
+    for (int i = lo; i < hi; ++i)
+    {
+        int bit = pass.len >> 1;
+
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        } // end for (; j & bit)
+
+        j ^= bit;
+
+        if (i < j)
+        {
+            unsigned int temp = pass.data[i];
+            pass.data[i] = pass.data[j];
+            pass.data[j] = temp;
+        } // end if (i < j)
+    } // end for (int i = lo)
+} // end reverseTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Task that fills one range of the table of powers of a root of unity.
+ * @param context  The NttPass; twiddle, len and value, the root, are used.
+ * @param index  The range of the len / 2 powers.
+ * @pre None.
+ * @post The range of twiddle holds the powers of the root.
+ */
+template <unsigned int MOD>
+static void twiddleTask(void *context, int index)
+{
+    const NttPass& pass = *static_cast<NttPass*>(context);
+    int lo, hi;
+
+    cutRange(pass.len / 2, pass.tasks, index, lo, hi);
+
+    unsigned long long power = powMod(pass.value, lo, MOD);
+
+    for (int k = lo; k < hi; ++k)
+    {
+        pass.twiddle[k] = static_cast<unsigned int>(power);
+        power = power * pass.value % MOD;
+    } // end for (int k = lo)
+} // end twiddleTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Task that runs every level of butterflies no wider than a block on one
+ * range of blocks. A block stays in the L1 cache through all of them.
+ * @param context  The NttPass; data, twiddle, len and half, the block
+ *                 length, are used.
+ * @param index  The range of blocks.
+ * @pre The bit-reversal permutation and the twiddle table are done.
+ * @post The blocks in the range hold their transforms.
+ */
+template <unsigned int MOD>
+static void blockTask(void *context, int index)
+{
+    const NttPass& pass = *static_cast<NttPass*>(context);
+    int block = pass.half;
+    int lo, hi;
+
+    cutRange(pass.len / block, pass.tasks, index, lo, hi);
+
+    for (int first = lo * block; first < hi * block; first += block)
+    {
+        for (int half = 1; half < block; half <<= 1)
+        {
+            int stride = pass.len / (2 * half);
+
+            for (int start = first; start < first + block; start += 2 * half)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    butterfly<MOD>(pass.data[start + k],
+                                   pass.data[start + k + half],
+                                   pass.twiddle[k * stride]);
+                } // end for (int k = 0)
+            } // end for (int start = first)
+        } // end for (int half = 1)
+    } // end for (int first = lo * block)
+} // end blockTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Task that runs one range of the butterflies of a level wider than a
+ * block. Butterfly t pairs element t / half * 2 half + t % half with the one
+ * half above it.
+ * @param context  The NttPass; data, twiddle, len and half are used.
+ * @param index  The range of the len / 2 butterflies.
+ * @pre Every narrower level is done.
+ * @post The butterflies in the range are done.
+ */
+template <unsigned int MOD>
+static void levelTask(void *context, int index)
+{
+    const NttPass& pass = *static_cast<NttPass*>(context);
+    int half = pass.half;
+    int stride = pass.len / (2 * half);
+    int lo, hi;
+
+    cutRange(pass.len / 2, pass.tasks, index, lo, hi);
+
+    while (lo < hi)
+    {
+        int start = lo / half * 2 * half;
+        int k = lo % half;
+        int end = hi - lo < half - k ? k + hi - lo : half;
+
+        lo += end - k;
+
+        for (; k < end; ++k)
+        {
+            butterfly<MOD>(pass.data[start + k], pass.data[start + k + half],
+                           pass.twiddle[k * stride]);
+        } // end for (; k < end)
+    } // end while (lo < hi)
+} // end levelTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Task that multiplies one range of an array elementwise, either by a second
+ * array or, if there is none, by a constant.
+ * @param context  The NttPass; data, len, and other or value, are used.
+ * @param index  The range.
+ * @pre None.
+ * @post The range of data holds the products.
+ */
+template <unsigned int MOD>
+static void scaleTask(void *context, int index)
+{
+    const NttPass& pass = *static_cast<NttPass*>(context);
+    int lo, hi;
+
+    cutRange(pass.len, pass.tasks, index, lo, hi);
+
+    for (int i = lo; i < hi; ++i)
+    {
+        unsigned long long factor = pass.other != NULL ? pass.other[i]
+                                                       : pass.value;
+
+        pass.data[i] = static_cast<unsigned int>(pass.data[i] * factor % MOD);
+    } // end for (int i = lo)
+} // end scaleTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Transforms an array in place, modulo a prime, with an iterative radix-2
+ * Cooley-Tukey butterfly. The prime is a template parameter so that the
+ * compiler can replace each % with a multiplication. len must divide
+ * MOD - 1. The levels no wider than NTT_BLOCK are done one block at a time,
+ * while the block is in cache; each wider level is one pass over the array.
+ * Given a pool, every pass is cut into ranges run on its threads.
+ * @param data  The array to transform.
+ * @param len  The number of elements in data; a power of 2.
+ * @param inverse  true to apply the inverse transform, including the final
+ *                 division by len; false for the forward transform.
+ * @param workers  The pool to run the passes on, or NULL.
+ * @pre All elements of data are less than MOD.
+ * @post data holds its transform, with all elements less than MOD.
+ */
+template <unsigned int MOD>
+static void transform(unsigned int *data, int len, bool inverse,
+                      ThreadPool *workers)
+{
+    const unsigned int mod = MOD;
+    NttPass pass = { data, NULL, NULL, 0, NULL, len, 0, 0, 1 };
+
+    pass.tasks = taskCount(workers, len, PASS_GRAIN);
+    runPass(workers, pass.tasks, reverseTask, &pass);
+
+    if (len < 2)
+    {
+        return;
+    } // end if (len < 2)
+
+    // powers of a primitive len-th root of unity, shared by every level
+    unsigned int root = powMod(ROOT, (mod - 1) / len, mod);
+    ScratchBuffer buffer(len / 2);
+
+    if (inverse)
+    {
+        root = powMod(root, mod - 2, mod);
+    } // end if (inverse)
+
+    pass.twiddle = buffer.data();
+    pass.value = root;
+    pass.tasks = taskCount(workers, len / 2, PASS_GRAIN);
+    runPass(workers, pass.tasks, twiddleTask<MOD>, &pass);
+
+    pass.half = len < NTT_BLOCK ? len : NTT_BLOCK;
+    pass.tasks = taskCount(workers, len / pass.half, 1);
+    runPass(workers, pass.tasks, blockTask<MOD>, &pass);
+
+    for (int half = pass.half; half < len; half <<= 1)
+    {
+        pass.half = half;
+        pass.tasks = taskCount(workers, len / 2, PASS_GRAIN);
+        runPass(workers, pass.tasks, levelTask<MOD>, &pass);
+    } // end for (int half = pass.half)
+
+    if (inverse)
+    {
+        pass.value = powMod(len, mod - 2, mod);
+        pass.tasks = taskCount(workers, len, PASS_GRAIN);
+        runPass(workers, pass.tasks, scaleTask<MOD>, &pass);
+    } // end if (inverse)
+} // end transform(unsigned int*, int, bool, ThreadPool*)
+
+/**----------------------------------------------------------------------------
+ * Computes the product of two coefficient arrays modulo one prime. When b is
+ * a and m is n, a is transformed once and squared pointwise.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The transform length; a power of 2 no less than n + m - 1.
+ * @param result  The array to receive the product modulo MOD; len elements.
+ * @param scratch  Scratch space of len elements.
+ * @param workers  The pool to run the passes on, or NULL.
+ * @pre result and scratch do not overlap.
+ * @post The first n + m - 1 elements of result hold the product, with each
+ *       coefficient read as an unsigned 32-bit value and reduced mod MOD.
+ */
+template <unsigned int MOD>
+static void convolve(const int *a, int n, const int *b, int m, int len,
+                     unsigned int *result, unsigned int *scratch,
+                     ThreadPool *workers)
+{
+    bool square = b == a && m == n;
+    int tasks = taskCount(workers, len, PASS_GRAIN);
+    NttPass pass = { result, NULL, a, n, NULL, len, 0, 0, tasks };
+
+    runPass(workers, tasks, loadTask<MOD>, &pass);
+    transform<MOD>(result, len, false, workers);
+
+    if (square)
+    {
+        scratch = result;
+    }
+    else
+    {
+        pass.data = scratch;
+        pass.source = b;
+        pass.count = m;
+        runPass(workers, tasks, loadTask<MOD>, &pass);
+        transform<MOD>(scratch, len, false, workers);
+    } // end if (square)
+
+    pass.data = result;
+    pass.other = scratch;
+    runPass(workers, tasks, scaleTask<MOD>, &pass);
+    transform<MOD>(result, len, true, workers);
+} // end convolve(const int*, int, const int*, int, int, ...)
+
+// the residues of a product modulo the three primes, joined one range of
+// coefficients per task
+struct NttResidues
+{
+    const unsigned int *res1;
+    const unsigned int *res2;
+    const unsigned int *res3;
+    int count;      // coefficients to join
+    int tasks;
+    int *out;
+};
+
+/**----------------------------------------------------------------------------
+ * Task that joins the residues of one range of coefficients with Garner's
+ * algorithm: x = r1 + p1 * t2 + p1 * p2 * t3, kept to its low 32 bits.
+ * @param context  The NttResidues.
+ * @param index  The range.
+ * @pre The three convolutions are done.
+ * @post The range of out holds the coefficients, wrapped around to 32 bits.
+ */
+static void garnerTask(void *context, int index)
+{
+    const NttResidues& join = *static_cast<NttResidues*>(context);
+    const unsigned long long p1p2 =
+            static_cast<unsigned long long>(PRIME1) * PRIME2;
+    const unsigned long long inv1 = powMod(PRIME1 % PRIME2, PRIME2 - 2, PRIME2);
+    const unsigned long long inv12 = powMod(
+            static_cast<unsigned int>(p1p2 % PRIME3), PRIME3 - 2, PRIME3);
+    const unsigned int *res1 = join.res1;
+    const unsigned int *res2 = join.res2;
+    const unsigned int *res3 = join.res3;
+    int lo, hi;
+
+    cutRange(join.count, join.tasks, index, lo, hi);
+
+    for (int k = lo; k < hi; ++k)
+    {
+        unsigned long long t2 = (res2[k] + PRIME2 - res1[k] % PRIME2) % PRIME2
+                                * inv1 % PRIME2;
+        unsigned long long low = res1[k] + PRIME1 * t2;
+        unsigned long long t3 = (res3[k] + PRIME3 - low % PRIME3) % PRIME3
+                                * inv12 % PRIME3;
+
+        // the exact value is below p1 * p2 * p3; keep its low 32 bits
+        join.out[k] = static_cast<int>(static_cast<unsigned int>(low)
+                      + static_cast<unsigned int>(p1p2)
+                        * static_cast<unsigned int>(t3));
+    } // end for (int k = lo)
+} // end garnerTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Computes the lowest coefficients of the product of two coefficient arrays
+ * with the number-theoretic transform; the body of mulNtt() and mulLowNtt().
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param count  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @param workers  The pool to run the passes on, or NULL.
+ * @pre n and m are greater than 0 and n + m - 1 is no more than
+ *      NTT_MAX_LENGTH. count is no more than n + m - 1. out has room for
+ *      count elements and does not overlap a or b.
+ * @post out holds the count lowest coefficients of the product, wrapped
+ *       around to 32 bits.
+ */
+static void nttProduct(const int *a, int n, const int *b, int m, int count,
+                       int *out, ThreadPool *workers)
+{
+    int len = 1;
+
+    // a cyclic product wraps every coefficient at or above x^len onto the
+    // low ones, so even a truncated product needs the full length
+    while (len < n + m - 1)
+    {
+        len <<= 1;
+    } // end while (len < n + m - 1)
+
+    ScratchBuffer buffer(4 * len);
+    unsigned int *res1 = buffer.data();
+    unsigned int *res2 = res1 + len;
+    unsigned int *res3 = res2 + len;
+    unsigned int *scratch = res3 + len;
+
+    convolve<PRIME1>(a, n, b, m, len, res1, scratch, workers);
+    convolve<PRIME2>(a, n, b, m, len, res2, scratch, workers);
+    convolve<PRIME3>(a, n, b, m, len, res3, scratch, workers);
+
+    NttResidues join = { res1, res2, res3, count,
+                         taskCount(workers, count, PASS_GRAIN), out };
+
+    runPass(workers, join.tasks, garnerTask, &join);
+} // end nttProduct(const int*, int, const int*, int, int, int*, ...)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays with the number-theoretic transform.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @param workers  The pool to spread each pass of the transforms over, or
+ *                 NULL to run them on the calling thread.
+ * @pre n and m are greater than 0 and n + m - 1 is no more than
+ *      NTT_MAX_LENGTH. out has room for n + m - 1 elements and does not
+ *      overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product, wrapped around
+ *       to 32 bits.
+ */
+void mulNtt(const int *a, int n, const int *b, int m, int *out,
+            ThreadPool *workers)
+{
+    nttProduct(a, n, b, m, n + m - 1, out, workers);
+} // end mulNtt(const int*, int, const int*, int, int*, ThreadPool*)
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays with the number-theoretic transform. Elements of either operand at
+ * or above x^len are dropped before the transforms, and only the
+ * coefficients wanted are recovered from their residues. The transforms
+ * still cover the whole truncated product: one of length L adds the
+ * coefficient of x^(L + k) into that of x^k, so any L short of the
+ * truncated length would spoil the lowest coefficients. The savings of a
+ * short product come from the split in mulLowKaratsuba() instead.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      The truncated product has no more than NTT_MAX_LENGTH coefficients.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the len lowest coefficients of the product, wrapped
+ *       around to 32 bits.
+ */
+void mulLowNtt(const int *a, int n, const int *b, int m, int len, int *out)
+{
+    nttProduct(a, n < len ? n : len, b, m < len ? m : len, len, out, NULL);
+} // end mulLowNtt(const int*, int, const int*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array with the number-theoretic transform. The
+ * operand is transformed once per prime and squared pointwise, which saves a
+ * third of the transforms of mulNtt().
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @param workers  The pool to spread each pass of the transforms over, or
+ *                 NULL to run them on the calling thread.
+ * @pre n is greater than 0 and 2n - 1 is no more than NTT_MAX_LENGTH. out has
+ *      room for 2n - 1 elements and does not overlap a.
+ * @post out holds the 2n - 1 coefficients of the square, wrapped around to 32
+ *       bits.
+ */
+void sqrNtt(const int *a, int n, int *out, ThreadPool *workers)
+{
+    // convolve() spots the repeated operand
+    mulNtt(a, n, a, n, out, workers);
+} // end sqrNtt(const int*, int, int*, ThreadPool*)
@@ -0,0 +1,85 @@
+/**
+ * @file    ntt.h
+ * @brief   Number-theoretic transform multiplication for the coefficient
+ *          arrays behind Poly. Both operands are transformed modulo three
+ *          primes of the form c * 2^k + 1, multiplied pointwise and
+ *          transformed back. The three residues of each coefficient are then
+ *          joined with the Chinese remainder theorem and reduced to 32 bits,
+ *          which gives exactly the wrapped-around result of the schoolbook
+ *          loop as long as the product has no more than NTT_MAX_LENGTH
+ *          coefficients. A square needs only one forward transform per
+ *          prime instead of two, and a truncated product recovers only the
+ *          coefficients asked for. Given a thread pool, each pass of the
+ *          transforms is cut into ranges run on its threads.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _NTT_H
+#define	_NTT_H
+
+#include <cstddef>
+
+class ThreadPool;
+
+// largest product length supported by all three primes
+const int NTT_MAX_LENGTH = 1 << 23;
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays with the number-theoretic transform.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @param workers  The pool to spread each pass of the transforms over, or
+ *                 NULL to run them on the calling thread.
+ * @pre n and m are greater than 0 and n + m - 1 is no more than
+ *      NTT_MAX_LENGTH. out has room for n + m - 1 elements and does not
+ *      overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product, wrapped around
+ *       to 32 bits.
+ */
+void mulNtt(const int *a, int n, const int *b, int m, int *out,
+            ThreadPool *workers = NULL);
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array with the number-theoretic transform. The
+ * operand is transformed once per prime and squared pointwise, which saves a
+ * third of the transforms of mulNtt().
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @param workers  The pool to spread each pass of the transforms over, or
+ *                 NULL to run them on the calling thread.
+ * @pre n is greater than 0 and 2n - 1 is no more than NTT_MAX_LENGTH. out
+ *      has room for 2n - 1 elements and does not overlap a.
+ * @post out holds the 2n - 1 coefficients of the square, wrapped around to
+ *       32 bits.
+ */
+void sqrNtt(const int *a, int n, int *out, ThreadPool *workers = NULL);
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays with the number-theoretic transform. Elements of either operand at
+ * or above x^len are dropped before the transforms, and only the
+ * coefficients wanted are recovered from their residues. The transforms
+ * still cover the whole truncated product: one of length L adds the
+ * coefficient of x^(L + k) into that of x^k, so any L short of the
+ * truncated length would spoil the lowest coefficients. The savings of a
+ * short product come from the split in mulLowKaratsuba() instead.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      The truncated product has no more than NTT_MAX_LENGTH coefficients.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the len lowest coefficients of the product, wrapped
+ *       around to 32 bits.
+ */
+void mulLowNtt(const int *a, int n, const int *b, int m, int len, int *out);
+
+#endif	/* _NTT_H */
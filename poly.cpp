@@ -16,17 +16,81 @@
  * @date    January 11, 2012
  */
 
+#include <algorithm>
+#include <fstream>
 #include "poly.h"
+#include "polydiv.h"
+#include "polyeval.h"
+#include "polyformat.h"
+#include "polymap.h"
+#include "polymul.h"
+#include "polyparse.h"
+#include "polyserial.h"
+#include "polysimd.h"
+#include "scratch.h"
+
+// smallest length at which a Poly may switch to the sparse form
+static const int SPARSE_MIN_LENGTH = 64;
+
+// term pairs a sparse product forms and sorts in the time the dense kernels
+// take per power of the product
+static const int PAIRS_PER_POWER = 8;
+
+// fill ratio below which the sparse form is used
+double Poly::densityThreshold = 0.125;
 
 /**----------------------------------------------------------------------------
- * Default constructor. Creates a Poly of size 1 with the x^0 coefficient set
- * to 0.
+ * Counts the non-zero elements of part of a coefficient list.
+ * @param list  The first element to count.
+ * @param count  The number of elements to count.
+ * @pre list has at least count elements.
+ * @post None.
+ * @return The number of non-zero elements.
+ */
+static int countNonzero(const int *list, int count)
+{
+    int total = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        total += list[i] != 0;
+    } // end for (int i = 0)
+
+    return total;
+} // end countNonzero(const int*, int)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two residues modulo a number below 2^31 without a division:
+ * the quotient is estimated in floating point, which is off by at most 1
+ * since it is below 2^31, and the exact product less that multiple of the
+ * modulus is corrected into range.
+ * @param a  The first residue.
+ * @param b  The second residue.
+ * @param mod  The modulus.
+ * @param inverse  1.0 / mod.
+ * @pre a and b are from 0 to mod - 1.
+ * @post None.
+ * @return a * b modulo mod.
+ */
+static long long mulMod(long long a, long long b, long long mod,
+                        double inverse)
+{
+    long long quot = static_cast<long long>(static_cast<double>(a) * b
+                                            * inverse);
+    long long rem = a * b - quot * mod;
+
+    return rem < 0 ? rem + mod : rem >= mod ? rem - mod : rem;
+} // end mulMod(long long, long long, long long, double)
+
+/**----------------------------------------------------------------------------
+ * Default constructor. Creates a Poly that represents 0, using the inline
+ * buffer for its coefficient list.
  * @pre None.
- * @post Poly has size 1 and its first element is 0
+ * @post Poly has degree -1 and represents 0.
  */
-Poly::Poly() : size(1)
+Poly::Poly() : coeffList(local), size(0), capacity(INLINE_CAPACITY),
+               nonzero(0), sparse(false), mapped(false)
 {
-    coeffList = new int[size];
     coeffList[0] = 0;
 } // end Default Constructor
 
@@ -35,11 +99,13 @@ Poly::Poly() : size(1)
  * coefficient set to a specified value.
  * @param coeff  The coefficient of the x^0 value.
  * @pre None.
- * @post Poly has size 1 and its first element is equal to coeff.
+ * @post Poly has degree 0 and its first element is equal to coeff, or degree
+ *       -1 if coeff is 0.
  */
-Poly::Poly(int coeff) : size(1)
+Poly::Poly(int coeff) : coeffList(local), size(coeff != 0),
+                        capacity(INLINE_CAPACITY), nonzero(coeff != 0),
+                        sparse(false), mapped(false)
 {
-    coeffList = new int[size];
     coeffList[0] = coeff;
 } // end 1 Parameter Constructor
 
@@ -51,10 +117,21 @@ Poly::Poly(int coeff) : size(1)
  *             exponent. Only the absolute value of exp is used.
  * @pre None.
  * @post Poly has size greater than exp and its last element is equal to coeff.
- *       any earlier elements are equal to 0.
+ *       any earlier elements are equal to 0. A single term of a large power
+ *       starts out in the sparse form. A power above MAX_POWER cannot be
+ *       held, and the Poly represents 0 instead.
  */
-Poly::Poly(int coeff, int exp)
+Poly::Poly(int coeff, int exp) : coeffList(local), capacity(INLINE_CAPACITY),
+                                 nonzero(coeff != 0), sparse(false),
+                                 mapped(false)
 {
+    if (exp < -MAX_POWER || exp > MAX_POWER)
+    {
+        size = 0;
+        nonzero = 0;
+        return;
+    } // end if (exp < -MAX_POWER || exp > MAX_POWER)
+
     if (exp < 0)
     {
         size = exp * -1 + 1;
@@ -64,7 +141,20 @@ Poly::Poly(int coeff, int exp)
         size = exp + 1;
     } // end if (exp < 0)
 
-    coeffList = new int[size];
+    if (prefersSparse(nonzero, size))
+    {
+        size = 0;
+        nonzero = 0;
+        terms.setCoeff(coeff, exp);
+        sparse = true;
+        return;
+    } // end if (prefersSparse(nonzero, size))
+
+    if (size > INLINE_CAPACITY)
+    {
+        capacity = size;
+        coeffList = new int[size];
+    } // end if (size > INLINE_CAPACITY)
 
     for (int i = 0; i < size - 1; ++i)
     {
@@ -72,6 +162,7 @@ Poly::Poly(int coeff, int exp)
     } // end for (int i = 0)
 
     coeffList[size - 1] = coeff;
+    trim();
 } // end 2 Parameter Constructor
 
 /**----------------------------------------------------------------------------
@@ -80,9 +171,16 @@ Poly::Poly(int coeff, int exp)
  * @pre None.
  * @post The new Poly is an exact copy of orig.
  */
-Poly::Poly(const Poly& orig) : size(orig.size)
+Poly::Poly(const Poly& orig) : coeffList(local), size(orig.size),
+                                capacity(INLINE_CAPACITY),
+                                nonzero(orig.nonzero), terms(orig.terms),
+                                sparse(orig.sparse), mapped(false)
 {
-    coeffList = new int[size];
+    if (size > INLINE_CAPACITY)
+    {
+        capacity = size;
+        coeffList = new int[size];
+    } // end if (size > INLINE_CAPACITY)
 
     for (int i = 0; i < size; ++i)
     {
@@ -91,108 +189,300 @@ Poly::Poly(const Poly& orig) : size(orig.size)
 } // end Copy Constructor
 
 /**----------------------------------------------------------------------------
- * Destructor. Sets each element to 0 before deleting the array. size is set to
- * 0 and the pointer coeffList is set to NULL for uniformity.
+ * Move constructor. Creates a Poly that takes over the coefficient list of a
+ * temporary instead of copying it. A list held in the inline buffer cannot be
+ * taken, so it is copied; it has no more than INLINE_CAPACITY elements.
+ * @param orig  The Poly whose coefficient list is taken.
+ * @pre None.
+ * @post The new Poly holds the polynomial that orig held. orig is empty, which
+ *       represents 0.
+ */
+Poly::Poly(Poly&& orig) noexcept
+    : coeffList(local), size(orig.size), capacity(INLINE_CAPACITY),
+      nonzero(orig.nonzero), terms(std::move(orig.terms)), sparse(orig.sparse),
+      mapped(orig.mapped)
+{
+    if (orig.coeffList != orig.local)
+    {
+        coeffList = orig.coeffList;
+        capacity = orig.capacity;
+    }
+    else
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            local[i] = orig.local[i];
+        } // end for (int i = 0)
+    } // end if (orig.coeffList != orig.local)
+
+    orig.coeffList = orig.local;
+    orig.size = 0;
+    orig.capacity = INLINE_CAPACITY;
+    orig.nonzero = 0;
+    orig.sparse = false;
+    orig.mapped = false;
+} // end Move Constructor
+
+/**----------------------------------------------------------------------------
+ * Destructor. Sets each element to 0 before deleting the array, unless it is
+ * the inline buffer. size is set to 0 and the pointer coeffList is set to NULL
+ * for uniformity. A mapped list is left as it is, since clearing it would
+ * copy every page of the mapping only to release them.
  * @pre None.
  * @post All allocated resources are returned to the system.
  */
 Poly::~Poly()
 {
-    for (int i = 0; i < size; ++i)
+    for (int i = 0; !mapped && i < size; ++i)
     {
         coeffList[i] = 0;
-    } // end for (int i = 0)
+    } // end for (int i = 0; !mapped && i < size)
 
     size = 0;
-    delete [] coeffList;
+    releaseList();
+    capacity = 0;
     coeffList = NULL;
 } // end Destructor
 
 /**----------------------------------------------------------------------------
- * Overloaded + operator. Adds this Poly to another and returns the result.
- * @param rhs  The Poly to be added to this one.
+ * Multiplies this Poly with another one; the body of operator*. Large
+ * operands are multiplied with Karatsuba's algorithm or the number-theoretic
+ * transform; see multiply() in polymul.h. If either operand is sparse, only
+ * its terms are multiplied. A Poly multiplied with itself is squared, which
+ * takes about half the work.
+ * @param rhs  The Poly to be multiplied with this one. May be this Poly.
  * @pre None.
  * @post This Poly and rhs remain unchanged.
- * @return A Poly that is the sum of this one and rhs.
+ * @return A Poly that is the product of this one and rhs.
  */
-Poly Poly::operator+(const Poly& rhs) const
+Poly Poly::product(const Poly& rhs) const
 {
-    // copy the larger Poly, then add the smaller one
-    if (size > rhs.size)
+    Poly prod;
+
+    if (sparse && rhs.sparse)
     {
-        Poly sum(*this);
+        mulSparse(*this, rhs, prod);
+    }
+    else if (sparse || rhs.sparse)
+    {
+        mulMixed(sparse ? rhs : *this, sparse ? *this : rhs, prod);
+    }
+    else if (size > 0 && rhs.size > 0)
+    {
+        // support largest power; a product with 0 is 0
+        prod.reserve(size + rhs.size - 1);
+        prod.size = size + rhs.size - 1;
+        multiply(coeffList, size, rhs.coeffList, rhs.size, prod.coeffList);
+        prod.trim();
+        prod.countTerms();
+    } // end if (sparse && rhs.sparse)
+
+    prod.adapt();
+    return prod;
+} // end product(const Poly&)
 
-        for (int i = 0; i < rhs.size; ++i)
-        {
-            sum.coeffList[i] += rhs.coeffList[i];
-        } // end for (int i = 0)
+/**----------------------------------------------------------------------------
+ * Copies the terms of this Poly below a power.
+ * @param n  The number of powers to keep. Values below 1 give 0.
+ * @pre None.
+ * @post This Poly remains unchanged.
+ * @return A Poly that is this one modulo x^n.
+ */
+Poly Poly::truncated(int n) const
+{
+    Poly low;
+
+    if (n <= 0)
+    {
+        return low;
+    } // end if (n <= 0)
+
+    if (sparse)
+    {
+        const vector<SparsePoly::Term>& list = terms.terms;
 
-        return sum;
+        low.makeSparse();
+        low.terms.terms.assign(list.begin(), list.begin() + terms.find(n));
     }
     else
     {
-        Poly sum(rhs);
+        int count = size < n ? size : n;
 
-        for (int i = 0; i < size; ++i)
+        low.reserve(count);
+
+        for (int i = 0; i < count; ++i)
         {
-            sum.coeffList[i] += coeffList[i];
+            low.coeffList[i] = coeffList[i];
         } // end for (int i = 0)
 
-        return sum;
-    } // if (size > rhs.size)
-} // end operator+(const Poly&)
+        low.size = count;
+        low.trim();
+        low.countTerms();
+    } // end if (sparse)
+
+    low.adapt();
+    return low;
+} // end truncated(int)
 
 /**----------------------------------------------------------------------------
- * Overloaded - operator. Subtracts another Poly from this one and returns the
- * result.
- * @param rhs  The Poly to be subtracted from this one.
- * @pre None.
- * @post This Poly and rhs remain unchanged.
- * @return A Poly that is the difference between this one and rhs.
+ * Evaluates the terms of a sparse Poly at a point, raising x from one
+ * term's power to the next by repeated squaring.
+ * @param x  The point to evaluate at.
+ * @pre This Poly is in the sparse form.
+ * @post This Poly remains unchanged.
+ * @return The value at x, wrapped around to 32 bits.
  */
-Poly Poly::operator-(const Poly& rhs) const
+int Poly::sumTerms(int x) const
 {
-    Poly diff(*this);
+    const vector<SparsePoly::Term>& list = terms.terms;
+    unsigned int power = 1, sum = 0;
+    int exp = 0;
 
-    // ensure new Poly is large enough
-    if (size < rhs.size)
+    // step the power of x from one term's exponent to the next
+    for (size_t t = 0; t < list.size(); ++t)
     {
-        diff.setCoeff(0, rhs.size - 1);
-    } // end if (size < rhs.size)
+        unsigned int square = static_cast<unsigned int>(x), factor = 1;
 
-    for (int i = 0; i < rhs.size; ++i)
-    {
-        diff.coeffList[i] -= rhs.coeffList[i];
-    } // end for (int i = 0)
+        for (unsigned int gap = list[t].exp - exp; gap > 0; gap >>= 1)
+        {
+            if (gap & 1)
+            {
+                factor *= square;
+            } // end if (gap & 1)
+
+            square *= square;
+        } // end for (unsigned int gap = list[t].exp - exp)
 
-    return diff;
-} // end operator-(const Poly&)
+        power *= factor;
+        exp = list[t].exp;
+        sum += static_cast<unsigned int>(list[t].coeff) * power;
+    } // end for (size_t t = 0)
+
+    return static_cast<int>(sum);
+} // end sumTerms(int)
 
 /**----------------------------------------------------------------------------
- * Overloaded * operator. Multiplies this Poly with another one and returns the
- * result.
- * @param rhs  The Poly to be multiplied with this one.
+ * Orders terms by power alone, so that a stable sort keeps terms of the same
+ * power in the order they were given.
+ * @param lhs  The first term.
+ * @param rhs  The second term.
  * @pre None.
- * @post This Poly and rhs remain unchanged.
- * @return A poly that is the product of this one and rhs.
+ * @post None.
+ * @return true if lhs has the lower power; false, otherwise.
  */
-Poly Poly::operator*(const Poly& rhs) const
+bool Poly::lowerPower(const SparsePoly::Term& lhs,
+                      const SparsePoly::Term& rhs)
 {
-    Poly prod;
+    return lhs.exp < rhs.exp;
+} // end lowerPower(const SparsePoly::Term&, const SparsePoly::Term&)
 
-    // support largest power
-    prod.setCoeff(0, size + rhs.size - 2);
+/**----------------------------------------------------------------------------
+ * Replaces the polynomial with the one given by a list of coefficient
+ * and power pairs, as if each pair were set in turn with setCoeff().
+ * The storage is sized and its form chosen once, from the largest
+ * power and the number of non-zero coefficients, rather than grown
+ * pair by pair.
+ * @param pairs  The pairs, coefficient first.
+ * @param count  The number of pairs.
+ * @pre pairs has 2 * count elements.
+ * @post This Poly holds the polynomial the pairs describe. A pair whose
+ *       power has no absolute value in an int is skipped.
+ */
+void Poly::assignPairs(const int *pairs, int count)
+{
+    const int skipped = -2147483647 - 1;
+    long long listed = 0;
+    int span = 0;
 
-    for (int i = 0; i < size; ++i)
+    for (int i = 0; i < count; ++i)
     {
-        for (int j = 0; j < rhs.size; ++j)
+        int exp = pairs[2 * i + 1];
+
+        if (pairs[2 * i] != 0 && exp != skipped)
         {
-            prod.coeffList[i + j] += coeffList[i] * rhs.coeffList[j];
-        } // end for (int j = 0)
+            int index = exp < 0 ? -exp : exp;
+
+            span = index >= span ? index + 1 : span;
+        } // end if (pairs[2 * i] != 0 && exp != skipped)
+
+        listed += pairs[2 * i] != 0;
     } // end for (int i = 0)
 
-    return prod;
-} // end operator*(const Poly&)
+    // start over from 0, keeping the current list for reuse
+    terms = SparsePoly();
+    sparse = false;
+    size = 0;
+    nonzero = 0;
+
+    if (prefersSparse(listed, span))
+    {
+        makeSparse();
+
+        vector<SparsePoly::Term>& list = terms.terms;
+        SparsePoly::Term term;
+
+        list.reserve(count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            int exp = pairs[2 * i + 1];
+
+            if (exp != skipped)
+            {
+                term.coeff = pairs[2 * i];
+                term.exp = exp < 0 ? -exp : exp;
+                list.push_back(term);
+            } // end if (exp != skipped)
+        } // end for (int i = 0)
+
+        stable_sort(list.begin(), list.end(), lowerPower);
+
+        // the last pair for a power wins; 0 clears it
+        size_t kept = 0;
+
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (i + 1 < list.size() && list[i + 1].exp == list[i].exp)
+            {
+                continue;
+            } // end if (i + 1 < list.size() && ...)
+
+            if (list[i].coeff != 0)
+            {
+                list[kept++] = list[i];
+            } // end if (list[i].coeff != 0)
+        } // end for (size_t i = 0)
+
+        list.resize(kept);
+    }
+    else
+    {
+        reserve(span);
+
+        for (int i = 0; i < span; ++i)
+        {
+            coeffList[i] = 0;
+        } // end for (int i = 0)
+
+        for (int i = 0; i < count; ++i)
+        {
+            int exp = pairs[2 * i + 1];
+            int index = exp < 0 && exp != skipped ? -exp : exp;
+
+            // a 0 above the leading term has nothing to clear
+            if (index >= 0 && index < span)
+            {
+                coeffList[index] = pairs[2 * i];
+            } // end if (index >= 0 && index < span)
+        } // end for (int i = 0)
+
+        size = span;
+        trim();
+        countTerms();
+    } // end if (prefersSparse(listed, span))
+
+    adapt();
+} // end assignPairs(const int*, int)
 
 /**----------------------------------------------------------------------------
  * Overloaded = operator. Sets this Poly to the same values as another one.
@@ -205,9 +495,18 @@ Poly& Poly::operator=(const Poly& rhs)
 {
     if (this != &rhs)
     {
-        delete [] coeffList;
+        // keep the current list if it is large enough
+        if (capacity < rhs.size)
+        {
+            releaseList();
+            capacity = rhs.size;
+            coeffList = new int[capacity];
+        } // end if (capacity < rhs.size)
+
         size = rhs.size;
-        coeffList = new int[size];
+        nonzero = rhs.nonzero;
+        terms = rhs.terms;
+        sparse = rhs.sparse;
 
         for (int i = 0; i < size; ++i)
         {
@@ -218,6 +517,55 @@ Poly& Poly::operator=(const Poly& rhs)
     return *this;
 } // end operator=(const Poly&)
 
+/**----------------------------------------------------------------------------
+ * Overloaded = operator for temporaries. Takes over the coefficient list of
+ * another Poly instead of copying it.
+ * @param rhs  The Poly whose coefficient list is taken.
+ * @pre None.
+ * @post This Poly holds the polynomial that rhs held. rhs is empty, which
+ *       represents 0.
+ * @return A reference to this Poly.
+ */
+Poly& Poly::operator=(Poly&& rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        if (rhs.coeffList != rhs.local)
+        {
+            releaseList();
+            coeffList = rhs.coeffList;
+            capacity = rhs.capacity;
+            mapped = rhs.mapped;
+        }
+        else
+        {
+            // a mapped list may hold fewer than INLINE_CAPACITY elements
+            if (rhs.size > capacity)
+            {
+                releaseList();
+            } // end if (rhs.size > capacity)
+
+            for (int i = 0; i < rhs.size; ++i)
+            {
+                coeffList[i] = rhs.local[i];
+            } // end for (int i = 0)
+        } // end if (rhs.coeffList != rhs.local)
+
+        size = rhs.size;
+        nonzero = rhs.nonzero;
+        terms = std::move(rhs.terms);
+        sparse = rhs.sparse;
+        rhs.coeffList = rhs.local;
+        rhs.size = 0;
+        rhs.capacity = INLINE_CAPACITY;
+        rhs.nonzero = 0;
+        rhs.sparse = false;
+        rhs.mapped = false;
+    } // end if (this != &rhs)
+
+    return *this;
+} // end operator=(Poly&&)
+
 /**----------------------------------------------------------------------------
  * Overloaded += operator. Adds another Poly to this one.
  * @param rhs  The Poly to be added to this one.
@@ -227,16 +575,7 @@ Poly& Poly::operator=(const Poly& rhs)
  */
 Poly& Poly::operator+=(const Poly& rhs)
 {
-    if (size < rhs.size)
-    {
-        setCoeff(0, rhs.size - 1);
-    } // end if (size < rhs.size)
-
-    for (int i = 0; i < size; ++i)
-    {
-        coeffList[i] += rhs.coeffList[i];
-    } // end for (int i = 0)
-
+    accumulate(rhs, false);
     return *this;
 } // end operator+=(const Poly&)
 
@@ -249,21 +588,16 @@ Poly& Poly::operator+=(const Poly& rhs)
  */
 Poly& Poly::operator-=(const Poly& rhs)
 {
-    if (size < rhs.size)
-    {
-        setCoeff(0, rhs.size - 1);
-    } // end if (size < rhs.size)
-
-    for (int i = 0; i < size; ++i)
-    {
-        coeffList[i] -= rhs.coeffList[i];
-    } // end for (int i = 0)
-
+    accumulate(rhs, true);
     return *this;
 } // end operator-=(const Poly&)
 
 /**----------------------------------------------------------------------------
- * Overloaded *= operator. Multiplies another Poly with this one.
+ * Overloaded *= operator. Multiplies another Poly with this one, using the
+ * same kernels as operator*. Dense products are written back into the
+ * coefficient list when it has room: by the schoolbook loop directly, from
+ * the top power down, or through a ScratchBuffer for the faster kernels.
+ * Otherwise the list grows to at least twice its capacity.
  * @param rhs  The Poly to be multiplied with this one.
  * @pre None.
  * @post The polynomial value of rhs has been multiplied with this Poly.
@@ -271,175 +605,1067 @@ Poly& Poly::operator-=(const Poly& rhs)
  */
 Poly& Poly::operator*=(const Poly& rhs)
 {
-    int *prod = new int[size + rhs.size - 1];
-
-    for (int i = 0; i < size; ++i)
+    // only dense operands are multiplied in place
+    if (sparse || rhs.sparse)
     {
-        for (int j = 0; j < rhs.size; ++j)
-        {
-            prod[i + j] += coeffList[i] * rhs.coeffList[j];
-        } // end for (int j = 0)
-    } // end for (int i = 0)
+        return *this = product(rhs);
+    } // end if (sparse || rhs.sparse)
 
-    delete [] coeffList;
-    coeffList = prod;
-    prod = NULL;
+    // a product with 0 is 0
+    if (size == 0 || rhs.size == 0)
+    {
+        size = 0;
+        nonzero = 0;
+        return *this;
+    } // end if (size == 0 || rhs.size == 0)
 
-    return *this;
-} // end operator*=(const Poly&)
+    int count = size + rhs.size - 1;
+    int shorter = size < rhs.size ? size : rhs.size;
 
-/**----------------------------------------------------------------------------
- * Overloaded == operator. Tests if the polynomial represented by this Poly is
- * equivalet to the polynomial represented by another Poly. Calls compare().
- * @param rhs  The Poly to compare with this one.
- * @pre None.
- * @post None.
- * @return true if the polynomial represented by this Poly is the same as that
- *         of rhs; false, otherwise.
- */
-bool Poly::operator==(const Poly& rhs) const
-{
-    if (size > rhs.size)
+    if (count > capacity)
     {
-        return compare(rhs, *this);
+        // grow geometrically, so a run of *= reallocates only now and then
+        int grown = count > 2 * capacity ? count : 2 * capacity;
+        int *prod = new int[grown];
+
+        multiply(coeffList, size, rhs.coeffList, rhs.size, prod);
+        releaseList();
+        coeffList = prod;
+        capacity = grown;
+        prod = NULL;
     }
-    else
+    else if (shorter < getKaratsubaThreshold())
     {
-        return compare(*this, rhs);
+        // the schoolbook loop can run top-down over the list itself
+        mulInPlace(coeffList, size, rhs.coeffList, rhs.size);
     }
+    else
+    {
+        // faster kernels need a separate output; borrow one and copy back
+        ScratchBuffer prod(count);
 
-    return true;
-} // end operator==(const Poly&)
+        multiply(coeffList, size, rhs.coeffList, rhs.size,
+                 reinterpret_cast<int*>(prod.data()));
+
+        for (int i = 0; i < count; ++i)
+        {
+            coeffList[i] = static_cast<int>(prod.data()[i]);
+        } // end for (int i = 0)
+    } // end if (count > capacity)
+
+    size = count;
+    trim();
+    countTerms();
+    adapt();
+
+    return *this;
+} // end operator*=(const Poly&)
 
 /**----------------------------------------------------------------------------
- * Overloaded == operator. Tests if the polynomial represented by this Poly is
- * not equivalet to the polynomial represented by another Poly.
- * @param rhs  The Poly to compare with this one.
+ * Squares this Poly with the square kernels, which need about half the
+ * multiplications of a general product; see square() in polymul.h.
  * @pre None.
- * @post None.
- * @return true if the polynomial represented by this Poly is different from
- *         that of rhs; false, otherwise.
+ * @post This Poly remains unchanged.
+ * @return A Poly that is the square of this one.
  */
-bool Poly::operator!=(const Poly& rhs) const
+Poly Poly::square() const
 {
-    return !(*this == rhs);
-} // end operator!=(const Poly&)
+    // product() passes the same list twice, which multiply() squares
+    return product(*this);
+} // end square()
 
 /**----------------------------------------------------------------------------
- * Accessor for an element of the coefficient list.
- * @param exp  The power (index) of the element whose coefficient is sought.
- * @pre exp is within the range of the coefficient list.
+ * Raises this Poly to a power by repeated squaring: the bits of n are read
+ * from the top, squaring the result for each and multiplying it by this Poly
+ * for each set bit. Working from the top means every product other than the
+ * squares is with the short original rather than with another large power.
+ * @param n  The power to raise this Poly to.
+ * @pre The degree of the result, n times the degree of this Poly, fits in an
+ *      int.
  * @post This Poly remains unchanged.
- * @return The coefficient of the indicated power if exp is within range of the
- *         coefficient list; 0, otherwise.
+ * @return A Poly that is this one to the power n; 1 if n is 0.
  */
-int Poly::getCoeff(int exp) const
+Poly Poly::pow(unsigned int n) const
 {
-    if (exp >= size || exp < 0)
+    if (n == 0)
     {
-        return 0;
-    } // end if (exp >= size)
+        return Poly(1);
+    } // end if (n == 0)
 
-    return coeffList[exp];
-} // end getCoeff(int)
+    int bit = 31;
+
+    while ((n >> bit & 1) == 0)
+    {
+        --bit;
+    } // end while ((n >> bit & 1) == 0)
+
+    // the top bit is the base itself
+    Poly result(*this);
+
+    for (--bit; bit >= 0; --bit)
+    {
+        result *= result;
+
+        if (n >> bit & 1)
+        {
+            result *= *this;
+        } // end if (n >> bit & 1)
+    } // end for (--bit)
+
+    return result;
+} // end pow(unsigned int)
 
 /**----------------------------------------------------------------------------
- * Mutator to set an element of the coefficient list.
- * @param coeff  The new coefficient of the indicated power.
- * @param exp  The power (index) of the element of the Poly to set. Only the
- *             absolute value of exp is used.
+ * Evaluates this Poly at many points at once, wrapping around modulo
+ * 2^32 like the rest of the arithmetic. Few points or short lists use
+ * Horner's rule over a vector of points in lockstep; many points on a
+ * long list use a subproduct tree, which takes about log2 of the number
+ * of points products and divisions instead of one pass per point; see
+ * evaluatePoints() in polyeval.h. A sparse Poly sums its terms, raising
+ * each point to their powers by repeated squaring.
+ * @param points  The points to evaluate at.
  * @pre None.
- * @post This Poly has the identified power set to the specified coefficient.
- *       If the identified power was outside of the range of the coefficient
- *       list, the list is expanded to accommodate it and all other new
- *       elements are set to 0.
+ * @post This Poly remains unchanged.
+ * @return The values at the points, in the same order.
  */
-void Poly::setCoeff(int coeff, int exp)
+vector<int> Poly::evaluateMany(const vector<int>& points) const
 {
-    int index = exp, *temp;
+    int count = static_cast<int>(points.size());
+    vector<int> values(count, 0);
 
-    if (exp < 0)
+    if (count == 0)
     {
-        index *= -1;
-    } // end if (exp < 0)
+        return values;
+    } // end if (count == 0)
 
-    // handle new boundary
-    if (index >= size)
+    if (!sparse)
     {
-        temp = new int[index + 1];
-
-        for (int i = 0; i < size; ++i)
+        if (size > 0)
         {
-            temp[i] = coeffList[i];
-        } // end for (int i = 0)
+            evaluatePoints(coeffList, size, &points[0], count, &values[0]);
+        } // end if (size > 0)
 
-        delete [] coeffList;
-        coeffList = temp;
+        return values;
+    } // end if (!sparse)
 
-        while(size < index)
-        {
-            coeffList[size++] = 0;
-        } // end while(size < index)
+    for (int j = 0; j < count; ++j)
+    {
+        values[j] = sumTerms(points[j]);
+    } // end for (int j = 0)
 
-        ++size;
-    } // end if (index >= size)
+    return values;
+} // end evaluateMany(const vector<int>&)
 
-    coeffList[index] = coeff;
-    temp = NULL;
-} // end setCoeff(int, int)
+/**----------------------------------------------------------------------------
+ * Evaluates this Poly at a point, wrapping around modulo 2^32 like the
+ * rest of the arithmetic. The coefficients are split into one chain
+ * per vector lane, evaluated in lockstep and joined with Estrin's
+ * scheme; see evalCoeffs() in polysimd.h. A sparse Poly sums its terms.
+ * @param x  The point to evaluate at.
+ * @pre None.
+ * @post This Poly remains unchanged.
+ * @return The value at x, wrapped around to 32 bits.
+ */
+int Poly::evaluate(int x) const
+{
+    if (sparse)
+    {
+        return sumTerms(x);
+    } // end if (sparse)
+
+    return size > 0 ? evalCoeffs(coeffList, size, x) : 0;
+} // end evaluate(int)
 
 /**----------------------------------------------------------------------------
- * Overloaded << operator. Writes the contents of this Poly to an ostream. Only
- * elements with a non-zero coefficient are displayed. x is displayed for all
- * powers greater than 0. For powers greater than 1, x is shown as x^y, where y
- * is the power. Positive value are prefixed with +. If there are no elements
- * to display, " 0" is written out.
- * @param output  The ostream to which to write out the polynomial.
- * @param source  The Poly from which to read a coefficient list (usually this
- *                Poly).
+ * Evaluates this Poly at a point exactly, checking for overflow. The
+ * value is found with Horner's rule in 64 bits. Once the running value
+ * passes 2^31 in size while x is neither -1, 0 nor 1, every later step
+ * at least doubles it, so the evaluation stops there.
+ * @param x  The point to evaluate at.
+ * @param value  The int to receive the value.
  * @pre None.
- * @post The ostream contains a string representing this Poly. This Poly
- *       remains unchanged.
- * @return A reference to the supplied ostream, containing a polynomial string.
+ * @post value holds the value at x if it fits in an int; otherwise it
+ *       is unchanged.
+ * @return true if the value at x fits in an int; false, otherwise.
  */
-ostream& operator<<(ostream& output, const Poly& source)
+bool Poly::evaluate(int x, int& value) const
 {
-    // to check special case of polynomial with all coefficients equal to 0
-    bool nonzero = false;
+    const long long limit = 1LL << 31;
+    long long point = x, sum = 0;
+    bool grows = x < -1 || x > 1;
 
-    for (int i = source.size - 1; i >= 0; --i)
+    if (!sparse)
     {
-        // only act if a non-zero coefficient is found
-        if (source.coeffList[i] != 0)
+        for (int i = size - 1; i >= 0; --i)
         {
-            nonzero = true;
-            cout << ' ';
-            
-            if (source.coeffList[i] > 0)
+            sum = sum * point + coeffList[i];
+
+            if (grows && (sum > limit || sum < -limit))
             {
-                cout << '+';
-            } // end if (source.coeffList[i] > 0)
+                return false;
+            } // end if (grows && (sum > limit || sum < -limit))
+        } // end for (int i = size - 1)
+    }
+    else
+    {
+        const vector<SparsePoly::Term>& list = terms.terms;
 
-            cout << source.coeffList[i];
+        // from the top term down, then on to x^0
+        for (int t = static_cast<int>(list.size()) - 1; t >= -1; --t)
+        {
+            int low = t >= 0 ? list[t].exp : 0;
+            unsigned int gap = t + 1 < static_cast<int>(list.size())
+                               ? list[t + 1].exp - low : 0;
 
-            if (i > 0)
+            if (!grows)
             {
-                cout << 'x';
-            } // end if (i > 0)
+                sum = x == 0 && gap > 0 ? 0 : sum;
+                sum = x == -1 && (gap & 1) ? -sum : sum;
+            } // end if (!grows)
 
-            if (i > 1)
+            for (; grows && gap > 0 && sum != 0; --gap)
             {
-                cout << '^' << i;
-            } // end if (i > 1)
-        } // end if (source->coeffList[i] != 0)
-    } // end for (int i = 0)
+                sum *= point;
 
-    if (!nonzero)
+                if (sum > limit || sum < -limit)
+                {
+                    return false;
+                } // end if (sum > limit || sum < -limit)
+            } // end for (; grows && gap > 0 && sum != 0)
+
+            sum += t >= 0 ? list[t].coeff : 0;
+        } // end for (int t = list.size() - 1)
+    } // end if (!sparse)
+
+    if (sum >= limit || sum < -limit)
+    {
+        return false;
+    } // end if (sum >= limit || sum < -limit)
+
+    value = static_cast<int>(sum);
+    return true;
+} // end evaluate(int, int&)
+
+/**----------------------------------------------------------------------------
+ * Evaluates this Poly at a point modulo a number, reading coefficients
+ * as signed. The reduced coefficients are joined in pairs with x, the
+ * pairs in pairs with x^2 and so on, by Estrin's scheme, so the
+ * multiplications of each round are independent of one another.
+ * @param x  The point to evaluate at.
+ * @param mod  The modulus.
+ * @pre mod is greater than 0.
+ * @post This Poly remains unchanged.
+ * @return The value at x modulo mod, from 0 to mod - 1.
+ */
+int Poly::evaluateMod(int x, int mod) const
+{
+    long long point = (static_cast<long long>(x) % mod + mod) % mod;
+
+    if (sparse)
+    {
+        const vector<SparsePoly::Term>& list = terms.terms;
+        long long power = 1 % mod, sum = 0;
+        int exp = 0;
+
+        for (size_t t = 0; t < list.size(); ++t)
+        {
+            long long square = point;
+
+            for (unsigned int gap = list[t].exp - exp; gap > 0; gap >>= 1)
+            {
+                if (gap & 1)
+                {
+                    power = power * square % mod;
+                } // end if (gap & 1)
+
+                square = square * square % mod;
+            } // end for (unsigned int gap = list[t].exp - exp)
+
+            exp = list[t].exp;
+            long long coeff = (static_cast<long long>(list[t].coeff) % mod
+                               + mod) % mod;
+
+            sum = (sum + coeff * power) % mod;
+        } // end for (size_t t = 0)
+
+        return static_cast<int>(sum);
+    } // end if (sparse)
+
+    if (size == 0)
+    {
+        return 0;
+    } // end if (size == 0)
+
+    ScratchBuffer buffer(size);
+    unsigned int *value = buffer.data();
+    double inverse = 1.0 / mod;
+
+    for (int i = 0; i < size; ++i)
+    {
+        int rem = coeffList[i] % mod;
+
+        value[i] = static_cast<unsigned int>(rem < 0 ? rem + mod : rem);
+    } // end for (int i = 0)
+
+    // each round halves the list; an odd last element carries over as is
+    for (int count = size; count > 1; count = (count + 1) / 2)
+    {
+        for (int i = 0; i < count / 2; ++i)
+        {
+            long long sum = value[2 * i]
+                            + mulMod(value[2 * i + 1], point, mod, inverse);
+
+            value[i] = static_cast<unsigned int>(sum >= mod ? sum - mod : sum);
+        } // end for (int i = 0)
+
+        if (count & 1)
+        {
+            value[count / 2] = value[count - 1];
+        } // end if (count & 1)
+
+        point = mulMod(point, point, mod, inverse);
+    } // end for (int count = size)
+
+    return static_cast<int>(value[0]);
+} // end evaluateMod(int, int)
+
+/**----------------------------------------------------------------------------
+ * Overloaded /= operator. Divides this Poly by another one and keeps the
+ * quotient; see divmod().
+ * @param rhs  The divisor. May be this Poly.
+ * @pre None.
+ * @post This Poly holds the quotient, or 0 if rhs has an even leading
+ *       coefficient or is 0.
+ * @return A reference to this Poly, the quotient of the input.
+ */
+Poly& Poly::operator/=(const Poly& rhs)
+{
+    Poly rem;
+
+    divmod(*this, rhs, *this, rem);
+    return *this;
+} // end operator/=(const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded %= operator. Divides this Poly by another one and keeps the
+ * remainder; see divmod().
+ * @param rhs  The divisor. May be this Poly.
+ * @pre None.
+ * @post This Poly holds the remainder, or is unchanged if rhs has an even
+ *       leading coefficient or is 0.
+ * @return A reference to this Poly, the remainder of the input.
+ */
+Poly& Poly::operator%=(const Poly& rhs)
+{
+    Poly quot;
+
+    divmod(*this, rhs, quot, *this);
+    return *this;
+} // end operator%=(const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Truncated product. Multiplies two polynomials but computes only the
+ * coefficients below x^n, with the short-product kernels; see mulLow() in
+ * polymul.h. If either operand is sparse, the terms at or above x^n are
+ * dropped from both before they are multiplied.
+ * @param lhs  The first factor.
+ * @param rhs  The second factor. May be lhs.
+ * @param n  The number of powers to keep. Values below 1 give 0.
+ * @pre None.
+ * @post lhs and rhs remain unchanged.
+ * @return A Poly that is the product of lhs and rhs modulo x^n.
+ */
+Poly mullo(const Poly& lhs, const Poly& rhs, int n)
+{
+    if (lhs.sparse || rhs.sparse)
+    {
+        return lhs.truncated(n).product(rhs.truncated(n)).truncated(n);
+    } // end if (lhs.sparse || rhs.sparse)
+
+    Poly prod;
+
+    if (n > 0 && lhs.size > 0 && rhs.size > 0)
+    {
+        int left = lhs.size < n ? lhs.size : n;
+        int right = rhs.size < n ? rhs.size : n;
+        int count = left + right - 1 < n ? left + right - 1 : n;
+
+        prod.reserve(count);
+        prod.size = count;
+        mulLow(lhs.coeffList, left, rhs.coeffList, right, count,
+               prod.coeffList);
+        prod.trim();
+        prod.countTerms();
+    } // end if (n > 0 && lhs.size > 0 && rhs.size > 0)
+
+    prod.adapt();
+    return prod;
+} // end mullo(const Poly&, const Poly&, int)
+
+/**----------------------------------------------------------------------------
+ * Divides one polynomial by another, giving a quotient and a remainder of
+ * lower degree than the divisor. The divisor must have an odd leading
+ * coefficient, the only kind that has an inverse modulo 2^32. Sparse
+ * operands are divided in the dense form; see divide() in polydiv.h.
+ * @param num  The dividend.
+ * @param den  The divisor.
+ * @param quot  The Poly to receive the quotient. May be num or den.
+ * @param rem  The Poly to receive the remainder. May be num or den, but not
+ *             quot.
+ * @pre None.
+ * @post If den is not 0 and its leading coefficient is odd, num is quot *
+ *       den + rem and rem has a lower degree than den. Otherwise quot is 0
+ *       and rem is num.
+ * @return true if the division was made; false if den is 0 or has an even
+ *         leading coefficient.
+ */
+bool divmod(const Poly& num, const Poly& den, Poly& quot, Poly& rem)
+{
+    int n = num.length(), m = den.length();
+    bool divisible = m > 0 && (den.getCoeff(m - 1) & 1) != 0;
+
+    if (!divisible || n < m)
+    {
+        // copy first, in case quot is num
+        Poly left(num);
+
+        quot = Poly();
+        rem = std::move(left);
+        return divisible;
+    } // end if (!divisible || n < m)
+
+    // divide dense lists, converting copies of sparse operands
+    Poly numList, denList;
+    const Poly *a = &num, *b = &den;
+
+    if (num.sparse)
+    {
+        numList = num;
+        numList.makeDense();
+        a = &numList;
+    } // end if (num.sparse)
+
+    if (den.sparse)
+    {
+        denList = den;
+        denList.makeDense();
+        b = &denList;
+    } // end if (den.sparse)
+
+    Poly q, r;
+
+    q.reserve(n - m + 1);
+    q.size = n - m + 1;
+    r.reserve(m - 1);
+    r.size = m - 1;
+    divide(a->coeffList, n, b->coeffList, m, q.coeffList, r.coeffList);
+
+    q.trim();
+    q.countTerms();
+    q.adapt();
+    r.trim();
+    r.countTerms();
+    r.adapt();
+
+    quot = std::move(q);
+    rem = std::move(r);
+    return true;
+} // end divmod(const Poly&, const Poly&, Poly&, Poly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded / operator. Divides one polynomial by another and returns the
+ * quotient; see divmod().
+ * @param num  The dividend.
+ * @param den  The divisor.
+ * @pre None.
+ * @post num and den remain unchanged.
+ * @return The quotient, or 0 if den has an even leading coefficient or is 0.
+ */
+Poly operator/(const Poly& num, const Poly& den)
+{
+    Poly quot, rem;
+
+    divmod(num, den, quot, rem);
+    return quot;
+} // end operator/(const Poly&, const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded % operator. Divides one polynomial by another and returns the
+ * remainder; see divmod().
+ * @param num  The dividend.
+ * @param den  The divisor.
+ * @pre None.
+ * @post num and den remain unchanged.
+ * @return The remainder, or num if den has an even leading coefficient or is
+ *         0.
+ */
+Poly operator%(const Poly& num, const Poly& den)
+{
+    Poly quot, rem;
+
+    divmod(num, den, quot, rem);
+    return rem;
+} // end operator%(const Poly&, const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded == operator. Tests if the polynomial represented by this Poly is
+ * equivalet to the polynomial represented by another Poly. Poly objects of
+ * different degrees are rejected at once; otherwise calls compare().
+ * @param rhs  The Poly to compare with this one.
+ * @pre None.
+ * @post None.
+ * @return true if the polynomial represented by this Poly is the same as that
+ *         of rhs; false, otherwise.
+ */
+bool Poly::operator==(const Poly& rhs) const
+{
+    // leading coefficients are never 0, so the degrees must match
+    if (degree() != rhs.degree())
+    {
+        return false;
+    } // end if (degree() != rhs.degree())
+
+    if (sparse || rhs.sparse)
+    {
+        if (termCount() != rhs.termCount())
+        {
+            return false;
+        } // end if (termCount() != rhs.termCount())
+
+        if (sparse && rhs.sparse)
+        {
+            return terms == rhs.terms;
+        } // end if (sparse && rhs.sparse)
+
+        // every term of the sparse one must be in the dense one
+        const Poly& dense = sparse ? rhs : *this;
+        const vector<SparsePoly::Term>& list = sparse ? terms.terms
+                                                      : rhs.terms.terms;
+
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (dense.getCoeff(list[i].exp) != list[i].coeff)
+            {
+                return false;
+            } // end if (dense.getCoeff(list[i].exp) != list[i].coeff)
+        } // end for (size_t i = 0)
+
+        return true;
+    } // end if (sparse || rhs.sparse)
+
+    return compare(*this, rhs);
+} // end operator==(const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded == operator. Tests if the polynomial represented by this Poly is
+ * not equivalet to the polynomial represented by another Poly.
+ * @param rhs  The Poly to compare with this one.
+ * @pre None.
+ * @post None.
+ * @return true if the polynomial represented by this Poly is different from
+ *         that of rhs; false, otherwise.
+ */
+bool Poly::operator!=(const Poly& rhs) const
+{
+    return !(*this == rhs);
+} // end operator!=(const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Accessor for an element of the coefficient list.
+ * @param exp  The power (index) of the element whose coefficient is sought.
+ * @pre exp is within the range of the coefficient list.
+ * @post This Poly remains unchanged.
+ * @return The coefficient of the indicated power if exp is within range of the
+ *         coefficient list; 0, otherwise.
+ */
+int Poly::getCoeff(int exp) const
+{
+    if (sparse)
+    {
+        return terms.getCoeff(exp);
+    } // end if (sparse)
+
+    if (exp >= size || exp < 0)
+    {
+        return 0;
+    } // end if (exp >= size)
+
+    return coeffList[exp];
+} // end getCoeff(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the degree of this Poly. Kept current by every mutator and
+ * operator, so it takes constant time.
+ * @pre None.
+ * @post None.
+ * @return The largest power with a non-zero coefficient, or -1 if this Poly
+ *         represents 0.
+ */
+int Poly::degree() const
+{
+    return sparse ? terms.degree() : size - 1;
+} // end degree()
+
+/**----------------------------------------------------------------------------
+ * Mutator to set an element of the coefficient list.
+ * @param coeff  The new coefficient of the indicated power.
+ * @param exp  The power (index) of the element of the Poly to set. Only the
+ *             absolute value of exp is used.
+ * @pre None.
+ * @post This Poly has the identified power set to the specified coefficient.
+ *       If the identified power was outside of the range of the coefficient
+ *       list, the list is expanded to accommodate it and all other new
+ *       elements are set to 0. The allocation at least doubles whenever it has
+ *       to grow, so setting powers in ascending order takes amortized constant
+ *       time per call. A power above MAX_POWER cannot be held and leaves this
+ *       Poly unchanged.
+ */
+void Poly::setCoeff(int coeff, int exp)
+{
+    int index = exp;
+
+    if (exp < -MAX_POWER || exp > MAX_POWER)
     {
-        cout << " 0";
-    } // end if (!nonzero)
+        return;
+    } // end if (exp < -MAX_POWER || exp > MAX_POWER)
+
+    if (exp < 0)
+    {
+        index *= -1;
+    } // end if (exp < 0)
+
+    if (sparse)
+    {
+        terms.setCoeff(coeff, index);
+        adapt();
+        return;
+    } // end if (sparse)
+
+    // handle new boundary; a 0 past the leading term changes nothing
+    if (index >= size)
+    {
+        if (coeff == 0)
+        {
+            return;
+        } // end if (coeff == 0)
+
+        // a distant power is cheaper to add as a term
+        if (prefersSparse(nonzero + (coeff != 0), index + 1))
+        {
+            makeSparse();
+            terms.setCoeff(coeff, index);
+            return;
+        } // end if (prefersSparse(nonzero + (coeff != 0), index + 1))
+
+        if (index >= capacity)
+        {
+            reserve(index + 1 > 2 * capacity ? index + 1 : 2 * capacity);
+        } // end if (index >= capacity)
+
+        // the new top element too, so the count below sees it as 0
+        while(size <= index)
+        {
+            coeffList[size++] = 0;
+        } // end while(size <= index)
+    } // end if (index >= size)
+
+    nonzero += (coeff != 0) - (coeffList[index] != 0);
+    coeffList[index] = coeff;
+    trim();
+    adapt();
+} // end setCoeff(int, int)
+
+/**----------------------------------------------------------------------------
+ * Ensures that the coefficient list has room for a number of elements without
+ * being reallocated. Useful before setting many coefficients one-at-a-time.
+ * @param count  The number of elements (one more than the largest power) that
+ *               should fit in the coefficient list.
+ * @pre None.
+ * @post This Poly can hold powers up to count - 1 without reallocating. The
+ *       polynomial it represents is unchanged. Has no effect while this Poly
+ *       is in the sparse form.
+ */
+void Poly::reserve(int count)
+{
+    if (!sparse && count > capacity)
+    {
+        int *temp = new int[count];
+
+        for (int i = 0; i < size; ++i)
+        {
+            temp[i] = coeffList[i];
+        } // end for (int i = 0)
+
+        releaseList();
+        coeffList = temp;
+        capacity = count;
+        temp = NULL;
+    } // end if (!sparse && count > capacity)
+} // end reserve(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the storage form of this Poly.
+ * @pre None.
+ * @post None.
+ * @return true if this Poly currently stores a list of terms; false, if it
+ *         stores a coefficient for every power.
+ */
+bool Poly::isSparse() const
+{
+    return sparse;
+} // end isSparse()
+
+/**----------------------------------------------------------------------------
+ * Mutator for the fill ratio at which Poly objects switch between the dense
+ * and sparse forms. A Poly spanning at least 64 powers becomes sparse when
+ * fewer than this fraction of its coefficients are non-zero, and becomes
+ * dense again once twice that fraction are.
+ * @param threshold  The new fill ratio, between 0 and 1. 0 keeps every Poly
+ *                   dense.
+ * @pre None.
+ * @post Poly objects adapt to the new threshold the next time they change.
+ */
+void Poly::setDensityThreshold(double threshold)
+{
+    densityThreshold = threshold;
+} // end setDensityThreshold(double)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the fill ratio at which Poly objects switch forms.
+ * @pre None.
+ * @post None.
+ * @return The fraction of non-zero coefficients below which a Poly is sparse.
+ */
+double Poly::getDensityThreshold()
+{
+    return densityThreshold;
+} // end getDensityThreshold()
+
+/**----------------------------------------------------------------------------
+ * Writes this Poly to a stream in the binary format of polyserial.h: a
+ * header, then the coefficient list if dense or the terms if sparse, each
+ * coefficient at the narrowest width that holds them all. The whole encoding
+ * goes to the stream in one write.
+ * @param output  The stream to write to; opened in binary mode.
+ * @param mappable  true to write a dense Poly at 4 bytes per coefficient
+ *                  whatever they hold, so that mapFile() can use its
+ *                  coefficient list where it lies in the file.
+ * @pre None.
+ * @post output holds the encoding. This Poly remains unchanged.
+ * @return true if output is still good after the write; false, otherwise.
+ */
+bool Poly::serialize(ostream& output, bool mappable) const
+{
+    const vector<SparsePoly::Term>& list = terms.terms;
+    int count = sparse ? static_cast<int>(list.size()) : size;
+
+    // the longest encoding, and while sparse the coefficients gathered
+    long long longest = sparse ? SERIAL_HEADER_SIZE + 4 + 9LL * count
+                               : SERIAL_HEADER_SIZE + 4LL * count;
+    int gather = sparse ? count : 0;
+    ScratchBuffer buffer(static_cast<int>((longest + 3) / 4) + gather);
+    int *coeffs = reinterpret_cast<int*>(buffer.data());
+    char *text = reinterpret_cast<char*>(buffer.data() + gather);
+    char *end = text + SERIAL_HEADER_SIZE;
+    SerialHeader header;
+
+    header.degree = degree();
+    header.count = termCount();
+
+    if (sparse)
+    {
+        int last = 0;
+
+        header.form = SERIAL_SPARSE;
+        end += 4;
+
+        for (int i = 0; i < count; ++i)
+        {
+            coeffs[i] = list[i].coeff;
+            end = putVarint(static_cast<unsigned int>(list[i].exp - last),
+                            end);
+            last = list[i].exp;
+        } // end for (int i = 0)
+
+        putWord(static_cast<unsigned int>(end - text - SERIAL_HEADER_SIZE
+                                          - 4), text + SERIAL_HEADER_SIZE);
+    }
+    else
+    {
+        header.form = SERIAL_DENSE;
+        coeffs = coeffList;
+    } // end if (sparse)
+
+    header.width = mappable && !sparse ? 4 : coeffWidth(coeffs, count);
+    writeHeader(header, text);
+    packCoeffs(coeffs, count, header.width, end);
+    end += header.width * count;
+
+    output.write(text, end - text);
+    return output.good();
+} // end serialize(ostream&, bool)
+
+/**----------------------------------------------------------------------------
+ * Reads a Poly written by serialize() from a stream. A dense body is read
+ * straight into the coefficient list and widened in place; a sparse one has
+ * its powers decoded from varints into the term list. Neither is parsed term
+ * by term.
+ * @param input  The stream to read from; opened in binary mode.
+ * @pre None.
+ * @post This Poly holds the polynomial read, in the form that suits its fill
+ *       ratio. If the stream ran out or held no valid encoding, failbit is
+ *       set on input and this Poly is unchanged.
+ * @return true if a Poly was read; false, otherwise.
+ */
+bool Poly::deserialize(istream& input)
+{
+    char head[SERIAL_HEADER_SIZE];
+    SerialHeader header;
+    Poly result;
+    bool valid = input.read(head, SERIAL_HEADER_SIZE)
+                 && readHeader(head, header);
+
+    if (valid && header.form == SERIAL_DENSE)
+    {
+        int count = header.degree + 1;
+
+        // the list grows only as the stream shows it holds the body, so a
+        // header cannot claim more memory than the data that follows it
+        while (valid && result.size < count)
+        {
+            if (result.size == result.capacity)
+            {
+                long long grown = 2LL * result.capacity;
 
-    return output;
+                grown = grown < SERIAL_CHUNK / 4 ? SERIAL_CHUNK / 4 : grown;
+                result.reserve(grown < count ? static_cast<int>(grown)
+                                             : count);
+            } // end if (result.size == result.capacity)
+
+            // read into the top of the free space, to be widened downwards
+            int n = (result.capacity < count ? result.capacity : count)
+                    - result.size;
+            int *slot = result.coeffList + result.size;
+            char *body = reinterpret_cast<char*>(slot)
+                         + static_cast<size_t>(4 - header.width) * n;
+
+            input.read(body, static_cast<streamsize>(header.width) * n);
+            valid = !input.fail();
+
+            if (valid)
+            {
+                unpackCoeffs(body, n, header.width, slot);
+                result.size += n;
+            } // end if (valid)
+        } // end while (valid && result.size < count)
+
+        if (valid)
+        {
+            result.countTerms();
+            valid = result.nonzero == header.count
+                    && (count == 0 || result.coeffList[count - 1] != 0);
+        } // end if (valid)
+
+        if (valid)
+        {
+            result.adapt();
+        } // end if (valid)
+    }
+    else if (valid)
+    {
+        int count = header.count;
+        char word[4];
+
+        input.read(word, sizeof(word));
+
+        // each power takes one to five bytes
+        long long powers = input.fail() ? -1 : getWord(word);
+
+        valid = powers >= count && powers <= 5LL * count;
+
+        // read in chunks that at most double what has arrived, so a header
+        // cannot claim more memory than the data that follows it
+        long long bytes = valid ? powers + 1LL * header.width * count : 0;
+        vector<char> body;
+
+        while (valid && static_cast<long long>(body.size()) < bytes)
+        {
+            long long filled = static_cast<long long>(body.size());
+            long long n = filled > SERIAL_CHUNK ? filled : SERIAL_CHUNK;
+
+            n = n < bytes - filled ? n : bytes - filled;
+            body.resize(static_cast<size_t>(filled + n));
+            input.read(&body[filled], static_cast<streamsize>(n));
+            valid = !input.fail();
+        } // end while (valid && ...)
+
+        // the body is all there, so the coefficients fit in memory too
+        ScratchBuffer buffer(valid ? count : 0);
+        int *coeffs = reinterpret_cast<int*>(buffer.data());
+        const char *p = body.data();
+        const char *end = p + (valid ? powers : 0);
+
+        if (valid)
+        {
+            vector<SparsePoly::Term>& list = result.terms.terms;
+            long long exp = -1;
+
+            unpackCoeffs(end, count, header.width, coeffs);
+            result.makeSparse();
+            list.resize(count);
+
+            // powers rise strictly to the degree, with no 0 coefficients
+            for (int i = 0; valid && i < count; ++i)
+            {
+                unsigned int gap;
+
+                p = getVarint(p, end, gap);
+                exp = i == 0 ? gap : exp + gap;
+                valid = p != NULL && (i == 0 || gap > 0)
+                        && exp <= header.degree && coeffs[i] != 0;
+                list[i].exp = static_cast<int>(exp);
+                list[i].coeff = coeffs[i];
+            } // end for (int i = 0; valid && i < count)
+
+            valid = valid && p == end && exp == header.degree;
+        } // end if (valid)
+
+        if (valid)
+        {
+            result.adapt();
+        } // end if (valid)
+    } // end if (valid && header.form == SERIAL_DENSE)
+
+    if (!valid)
+    {
+        input.setstate(ios::failbit);
+        return false;
+    } // end if (!valid)
+
+    *this = std::move(result);
+    return true;
+} // end deserialize(istream&)
+
+/**----------------------------------------------------------------------------
+ * Loads a Poly written by serialize() from a file without copying its
+ * coefficients into a new list: the list is mapped from the file, read once
+ * to check its terms against the header, and getCoeff(), evaluation and
+ * the const operators then read it where it lies. The mapping is private
+ * and copy-on-write, so changing this Poly copies only the pages it writes
+ * and never the file; growing it past the mapped list moves it to the heap.
+ * A body that is sparse, narrower than 4 bytes (see serialize()), not
+ * 4-byte aligned in the file, or on a machine that cannot map it is read
+ * with deserialize() instead.
+ * @param path  The name of the file.
+ * @param offset  The position in the file at which the Poly starts.
+ * @pre The file is not changed while this Poly maps it.
+ * @post This Poly holds the polynomial in the file. If the file could not be
+ *       read or held no valid encoding there, this Poly is unchanged.
+ * @return true if a Poly was loaded; false, otherwise.
+ */
+bool Poly::mapFile(const char *path, long long offset)
+{
+    ifstream input(path, ios::in | ios::binary);
+    char head[SERIAL_HEADER_SIZE];
+    SerialHeader header;
+    long long body = offset + SERIAL_HEADER_SIZE;
+    char *list = NULL;
+
+    if (!input.seekg(offset) || !input.read(head, SERIAL_HEADER_SIZE)
+        || !readHeader(head, header))
+    {
+        return false;
+    } // end if (!input.seekg(offset) || ...)
+
+    if (isNative(header) && header.degree >= 0 && body % 4 == 0)
+    {
+        list = mapRegion(path, body, 4LL * (header.degree + 1));
+    } // end if (isNative(header) && header.degree >= 0 && ...)
+
+    if (list == NULL)
+    {
+        input.seekg(offset);
+        return deserialize(input);
+    } // end if (list == NULL)
+
+    // the mapping belongs to result until it is known to be valid; the list
+    // is counted rather than trusting the header, which every consumer of
+    // nonzero sizes from
+    Poly result;
+
+    result.coeffList = reinterpret_cast<int*>(list);
+    result.size = header.degree + 1;
+    result.capacity = result.size;
+    result.mapped = true;
+    result.countTerms();
+
+    if (result.coeffList[header.degree] == 0
+        || result.nonzero != header.count)
+    {
+        return false;
+    } // end if (result.coeffList[header.degree] == 0 || ...)
+
+    result.adapt();
+    *this = std::move(result);
+    return true;
+} // end mapFile(const char*, long long)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the storage of the coefficient list.
+ * @pre None.
+ * @post None.
+ * @return true if the coefficient list is mapped from a file; false,
+ *         otherwise.
+ */
+bool Poly::isMapped() const
+{
+    return mapped;
+} // end isMapped()
+
+/**----------------------------------------------------------------------------
+ * Overloaded << operator. Writes the contents of this Poly to an ostream. Only
+ * elements with a non-zero coefficient are displayed. x is displayed for all
+ * powers greater than 0. For powers greater than 1, x is shown as x^y, where y
+ * is the power. Positive value are prefixed with +. If there are no elements
+ * to display, " 0" is written out. The text is rendered into one buffer with
+ * formatTerm() (see polyformat.h) and written to the stream in one call.
+ * @param output  The ostream to which to write out the polynomial.
+ * @param source  The Poly from which to read a coefficient list (usually this
+ *                Poly).
+ * @pre None.
+ * @post The ostream contains a string representing this Poly. This Poly
+ *       remains unchanged.
+ * @return A reference to the supplied ostream, containing a polynomial string.
+ */
+ostream& operator<<(ostream& output, const Poly& source)
+{
+    if (source.sparse)
+    {
+        return output << source.terms;
+    } // end if (source.sparse)
+
+    // room for every term, or for " 0"
+    ScratchBuffer buffer(source.nonzero * (TERM_TEXT_MAX / 4) + 1);
+    char *text = reinterpret_cast<char*>(buffer.data());
+    char *end = text;
+
+    for (int i = source.size - 1; i >= 0; --i)
+    {
+        // only act if a non-zero coefficient is found
+        if (source.coeffList[i] != 0)
+        {
+            end = formatTerm(end, source.coeffList[i], i);
+        } // end if (source.coeffList[i] != 0)
+    } // end for (int i = source.size - 1)
+
+    // special case of polynomial with all coefficients equal to 0
+    if (end == text)
+    {
+        *end++ = ' ';
+        *end++ = '0';
+    } // end if (end == text)
+
+    return output.write(text, end - text);
 } // end operator<<(ostream&, Poly&)
 
 /**----------------------------------------------------------------------------
@@ -459,61 +1685,485 @@ ostream& operator<<(ostream& output, const Poly& source)
  */
 istream& operator>>(istream& input, Poly& target)
 {
-    int coeff, exp;
-    input >> coeff >> exp;
+    vector<int> pairs;
 
-    // set all current elements to 0
-    for (int i = 0; i < target.size; ++i)
-    {
-        target.coeffList[i] = 0;
-    } // end for (int i = 0)
-
-    while(coeff != 0 || exp != 0)
-    {
-        target.setCoeff(coeff, exp);
-        input >> coeff >> exp;
-    } // end while(coeff != 0)
+    scanTerms(input, pairs);
+    target.assignPairs(pairs.empty() ? NULL : &pairs[0],
+                       static_cast<int>(pairs.size() / 2));
 
     return input;
 } // end operator>>(istream&, Poly&)
 
 /**----------------------------------------------------------------------------
- * Compares the coefficient list of two Poly objects of possibly different
- * sizes. They are considered equivalent if all the elements in the smaller
- * Poly match the beginning elements in the larger Poly and all of the later
- * elements in the larger Poly are equal to 0.
- * @param smaller  The Poly with the smaller size. May be the same as larger,
- *                 but cannot be greater.
- * @param larger  The Poly with the larger size. May be the same as smaller,
- *                but cannot be less.
- * @pre The size of smaller is less than or equal to the size of larger.
- * @post smaller and larger remain unchanged.
+ * Reads a coefficient list from a character buffer, in the same
+ * "coeff exp ... 0 0" text that operator>> reads, without going through
+ * a stream. Integers are decoded by hand with runs of digits found a
+ * vector of bytes at a time, and the pairs are placed in storage sized
+ * once for all of them; see scanTerms() in polyparse.h. Meant for
+ * large inputs read or mapped into memory whole; call it again from
+ * the position returned to read the next Poly.
+ * @param begin  The first character to read.
+ * @param end  One past the last character that may be read.
+ * @param target  The Poly to receive the coefficient list.
+ * @pre begin is no greater than end.
+ * @post target holds the pairs read, as if each were set in turn with
+ *       setCoeff(), including those read before a failure.
+ * @return One past the last digit of the terminating 0 0, or NULL if
+ *         the buffer ran out, held something other than integers or
+ *         held a power of INT_MAX or -INT_MAX first.
+ */
+const char *parsePoly(const char *begin, const char *end, Poly& target)
+{
+    vector<int> pairs;
+    const char *next = scanTerms(begin, end, pairs);
+
+    target.assignPairs(pairs.empty() ? NULL : &pairs[0],
+                       static_cast<int>(pairs.size() / 2));
+
+    return next;
+} // end parsePoly(const char*, const char*, Poly&)
+
+/**----------------------------------------------------------------------------
+ * Compares the coefficient lists of two dense Poly objects of the same degree
+ * element by element.
+ * @param lhs  The first Poly.
+ * @param rhs  The second Poly. May be the same as lhs.
+ * @pre Both are dense and have the same size.
+ * @post lhs and rhs remain unchanged.
  * @return true if both parameters represent equivalent polynomials; false,
  *         otherwise.
  */
-bool Poly::compare(const Poly& smaller, const Poly& larger) const
+bool Poly::compare(const Poly& lhs, const Poly& rhs) const
 {
-    int i = 0;
-
-    while(i < smaller.size)
+    for (int i = 0; i < lhs.size; ++i)
     {
-        if (smaller.coeffList[i] != larger.coeffList[i])
+        if (lhs.coeffList[i] != rhs.coeffList[i])
         {
             return false;
-        } // end if (smaller.coeffList[i] != larger.coeffList[i])
+        } // end if (lhs.coeffList[i] != rhs.coeffList[i])
+    } // end for (int i = 0)
 
-        ++i;
-    } // end while(i < smaller.size)
+    return true;
+} // end compare(const Poly&, const Poly&)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the number of powers this Poly spans.
+ * @pre None.
+ * @post None.
+ * @return One more than the largest power stored.
+ */
+int Poly::length() const
+{
+    return degree() + 1;
+} // end length()
 
-    while(i < larger.size)
+/**----------------------------------------------------------------------------
+ * Accessor for the number of non-zero coefficients.
+ * @pre None.
+ * @post None.
+ * @return The number of non-zero coefficients in either form.
+ */
+int Poly::termCount() const
+{
+    return sparse ? terms.termCount() : nonzero;
+} // end termCount()
+
+/**----------------------------------------------------------------------------
+ * Decides whether a polynomial with a given number of terms over a given span
+ * of powers is better kept in the sparse form.
+ * @param count  The number of non-zero coefficients.
+ * @param length  One more than the largest power.
+ * @pre None.
+ * @post None.
+ * @return true if the fill ratio is below the density threshold or the
+ *         span is too long for a coefficient list; false, otherwise.
+ */
+bool Poly::prefersSparse(long long count, long long length)
+{
+    // a list longer than an int can count is only held as terms
+    if (length > SparsePoly::MAX_POWER + 1LL)
+    {
+        return true;
+    } // end if (length > SparsePoly::MAX_POWER + 1LL)
+
+    return length >= SPARSE_MIN_LENGTH && count < densityThreshold * length;
+} // end prefersSparse(long long, long long)
+
+/**----------------------------------------------------------------------------
+ * Recounts the non-zero coefficients of the dense list.
+ * @pre This Poly is dense.
+ * @post nonzero matches the coefficient list.
+ */
+void Poly::countTerms()
+{
+    nonzero = countNonzero(coeffList, size);
+} // end countTerms()
+
+/**----------------------------------------------------------------------------
+ * Drops 0 elements from the top of the dense list so that its last element,
+ * if any, is the leading coefficient.
+ * @pre This Poly is dense.
+ * @post size is one more than the degree of this Poly.
+ */
+void Poly::trim()
+{
+    while (size > 0 && coeffList[size - 1] == 0)
     {
-        if (larger.coeffList[i] != 0)
+        --size;
+    } // end while (size > 0 && coeffList[size - 1] == 0)
+} // end trim()
+
+/**----------------------------------------------------------------------------
+ * Switches to the sparse form if the fill ratio has fallen below the density
+ * threshold, or back to the dense form once it has reached twice that. The
+ * gap between the two keeps a Poly from switching back and forth while it is
+ * built term by term.
+ * @pre nonzero is current.
+ * @post This Poly is in the form that suits its fill ratio.
+ */
+void Poly::adapt()
+{
+    if (!sparse && prefersSparse(nonzero, size))
+    {
+        makeSparse();
+    }
+    else if (sparse && !prefersSparse(terms.termCount() / 2, length()))
+    {
+        makeDense();
+    } // end if (!sparse && prefersSparse(nonzero, size))
+} // end adapt()
+
+/**----------------------------------------------------------------------------
+ * Converts this Poly to the sparse form and releases the coefficient list.
+ * @pre None.
+ * @post This Poly is sparse and represents the same polynomial.
+ */
+void Poly::makeSparse()
+{
+    if (!sparse)
+    {
+        terms = SparsePoly(*this);
+        releaseList();
+        size = 0;
+        nonzero = 0;
+        sparse = true;
+    } // end if (!sparse)
+} // end makeSparse()
+
+/**----------------------------------------------------------------------------
+ * Converts this Poly to the dense form and releases the term list.
+ * @pre None.
+ * @post This Poly is dense and represents the same polynomial.
+ */
+void Poly::makeDense()
+{
+    if (sparse)
+    {
+        const vector<SparsePoly::Term>& list = terms.terms;
+        int count = length();
+
+        sparse = false;
+        reserve(count);
+
+        for (int i = 0; i < count; ++i)
         {
-            return false;
-        } // end if (larger.coeffList[i] != 0)
+            coeffList[i] = 0;
+        } // end for (int i = 0)
 
-        ++i;
-    } // end while(i < larger.size)
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            coeffList[list[i].exp] = list[i].coeff;
+        } // end for (size_t i = 0)
 
-    return true;
-} // end compare (const Poly&, const Poly&)
+        size = count;
+        nonzero = static_cast<int>(list.size());
+        terms = SparsePoly();
+    } // end if (sparse)
+} // end makeDense()
+
+/**----------------------------------------------------------------------------
+ * Adds another Poly to this one or subtracts it, using whichever form suits
+ * the result. Sparse results are found by merging term lists; dense results
+ * by adding the coefficient lists with the vector kernels in polysimd.h, or
+ * by adding just the terms when rhs is sparse.
+ * @param rhs  The Poly to be added or subtracted. May be this Poly.
+ * @param subtract  true to subtract rhs; false to add it.
+ * @pre None.
+ * @post This Poly holds the sum or difference.
+ */
+void Poly::accumulate(const Poly& rhs, bool subtract)
+{
+    int count = length() > rhs.length() ? length() : rhs.length();
+
+    if ((sparse || rhs.sparse)
+        && prefersSparse(termCount() + rhs.termCount(), count))
+    {
+        makeSparse();
+
+        if (rhs.sparse)
+        {
+            terms = subtract ? terms - rhs.terms : terms + rhs.terms;
+        }
+        else
+        {
+            SparsePoly other(rhs);
+
+            terms = subtract ? terms - other : terms + other;
+        } // end if (rhs.sparse)
+    }
+    else
+    {
+        // if rhs is this Poly, it becomes dense as well
+        makeDense();
+        reserve(count);
+
+        while (size < count)
+        {
+            coeffList[size++] = 0;
+        } // end while (size < count)
+
+        if (rhs.sparse)
+        {
+            const vector<SparsePoly::Term>& list = rhs.terms.terms;
+
+            for (size_t i = 0; i < list.size(); ++i)
+            {
+                addTerm(list[i].exp, list[i].coeff, subtract);
+            } // end for (size_t i = 0)
+        }
+        else
+        {
+            // recount only the elements that change
+            nonzero -= countNonzero(coeffList, rhs.size);
+
+            if (subtract)
+            {
+                subCoeffs(coeffList, rhs.coeffList, rhs.size);
+            }
+            else
+            {
+                addCoeffs(coeffList, rhs.coeffList, rhs.size);
+            } // end if (subtract)
+
+            nonzero += countNonzero(coeffList, rhs.size);
+        } // end if (rhs.sparse)
+
+        trim();
+    } // end if ((sparse || rhs.sparse) && ...)
+
+    adapt();
+} // end accumulate(const Poly&, bool)
+
+/**----------------------------------------------------------------------------
+ * Adds a value to one element of the dense coefficient list, or subtracts
+ * it, wrapping around on overflow.
+ * @param exp  The power (index) of the element.
+ * @param coeff  The value to add or subtract.
+ * @param subtract  true to subtract coeff; false to add it.
+ * @pre This Poly is dense and exp is less than size.
+ * @post The element has changed by coeff and nonzero is current.
+ */
+void Poly::addTerm(int exp, int coeff, bool subtract)
+{
+    unsigned int value = static_cast<unsigned int>(coeffList[exp]);
+
+    if (subtract)
+    {
+        value -= static_cast<unsigned int>(coeff);
+    }
+    else
+    {
+        value += static_cast<unsigned int>(coeff);
+    } // end if (subtract)
+
+    nonzero += (value != 0) - (coeffList[exp] != 0);
+    coeffList[exp] = static_cast<int>(value);
+} // end addTerm(int, int, bool)
+
+/**----------------------------------------------------------------------------
+ * Multiplies a dense Poly with a sparse one. If the product is expected to be
+ * sparse, the dense operand is converted to terms first; otherwise each term
+ * adds a shifted, scaled copy of the dense list into a dense product.
+ * @param dense  The dense operand.
+ * @param sparse  The sparse operand.
+ * @param prod  The Poly to receive the product.
+ * @pre prod is a default-constructed Poly, which is 0.
+ * @post prod holds the product, not yet adapted to its fill ratio.
+ */
+void Poly::mulMixed(const Poly& dense, const Poly& sparse, Poly& prod)
+{
+    const vector<SparsePoly::Term>& list = sparse.terms.terms;
+
+    if (dense.size == 0 || list.empty())
+    {
+        return;
+    } // end if (dense.size == 0 || list.empty())
+
+    long long count = static_cast<long long>(dense.size)
+                      + sparse.terms.degree();
+
+    // at most this many products survive, fewer if powers overlap
+    long long estimate = static_cast<long long>(dense.nonzero) * list.size();
+
+    if (prefersSparse(estimate, count))
+    {
+        prod.makeSparse();
+        prod.terms = SparsePoly(dense) * sparse.terms;
+        return;
+    } // end if (prefersSparse(estimate, count))
+
+    prod.reserve(static_cast<int>(count));
+    prod.size = static_cast<int>(count);
+
+    for (int k = 0; k < count; ++k)
+    {
+        prod.coeffList[k] = 0;
+    } // end for (int k = 0)
+
+    for (size_t t = 0; t < list.size(); ++t)
+    {
+        scaleAddCoeffs(prod.coeffList + list[t].exp, dense.coeffList,
+                       list[t].coeff, dense.size);
+    } // end for (size_t t = 0)
+
+    prod.trim();
+    prod.countTerms();
+} // end mulMixed(const Poly&, const Poly&, Poly&)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two sparse Polys. Every term of one is paired with every term of
+ * the other, unless the pairs would cost more than densifying both operands
+ * and multiplying the coefficient lists with multiply().
+ * @param lhs  The first operand.
+ * @param rhs  The second operand. May be lhs, which is squared.
+ * @param prod  The Poly to receive the product.
+ * @pre lhs and rhs are sparse. prod is a default-constructed Poly, which is
+ *      0.
+ * @post prod holds the product, not yet adapted to its fill ratio. Terms
+ *       whose power would be above SparsePoly::MAX_POWER are dropped.
+ */
+void Poly::mulSparse(const Poly& lhs, const Poly& rhs, Poly& prod)
+{
+    long long pairs = static_cast<long long>(lhs.terms.termCount())
+                      * rhs.terms.termCount();
+    long long count = 1LL + lhs.terms.degree() + rhs.terms.degree();
+
+    if (pairs <= PAIRS_PER_POWER * count
+        || count > SparsePoly::MAX_POWER + 1LL)
+    {
+        prod.makeSparse();
+        prod.terms = lhs.terms * rhs.terms;
+        return;
+    } // end if (pairs <= PAIRS_PER_POWER * count || ...)
+
+    Poly left(lhs);
+    Poly right;
+
+    left.makeDense();
+
+    // a square keeps both operands in one list, so multiply() sees it
+    if (&rhs != &lhs)
+    {
+        right = rhs;
+        right.makeDense();
+    } // end if (&rhs != &lhs)
+
+    const Poly& other = &rhs != &lhs ? right : left;
+
+    prod.reserve(static_cast<int>(count));
+    prod.size = static_cast<int>(count);
+    multiply(left.coeffList, left.size, other.coeffList, other.size,
+             prod.coeffList);
+    prod.trim();
+    prod.countTerms();
+} // end mulSparse(const Poly&, const Poly&, Poly&)
+
+/**----------------------------------------------------------------------------
+ * Frees the coefficient list if it was allocated on the heap, or unmaps it if
+ * it was mapped from a file, and falls back to the inline buffer. Elements
+ * are not preserved.
+ * @pre None.
+ * @post coeffList is the inline buffer and capacity is INLINE_CAPACITY.
+ */
+void Poly::releaseList()
+{
+    if (mapped)
+    {
+        unmapRegion(reinterpret_cast<char*>(coeffList), 4LL * capacity);
+        mapped = false;
+    }
+    else if (coeffList != local)
+    {
+        delete [] coeffList;
+    } // end if (mapped)
+
+    coeffList = local;
+    capacity = INLINE_CAPACITY;
+} // end releaseList()
+
+/**----------------------------------------------------------------------------
+ * Accessor for a coefficient as an expression leaf.
+ * @param i  The power whose coefficient is sought; not negative.
+ * @pre This Poly is dense.
+ * @post None.
+ * @return The coefficient of x^i; 0 beyond the coefficient list.
+ */
+int Poly::coeff(int i) const
+{
+    return i < size ? coeffList[i] : 0;
+} // end coeff(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the storage form as an expression leaf.
+ * @pre None.
+ * @post None.
+ * @return true if this Poly is sparse; false, otherwise.
+ */
+bool Poly::hasSparse() const
+{
+    return sparse;
+} // end hasSparse()
+
+/**----------------------------------------------------------------------------
+ * Adds a multiple of this Poly to another one, or subtracts it; the
+ * expression leaf's part in evaluating an expression with a sparse operand.
+ * @param dest  The Poly to add to. Not this Poly.
+ * @param subtract  true to subtract; false to add.
+ * @param scale  The multiple of this Poly to add or subtract.
+ * @pre None.
+ * @post dest has changed by scale times this Poly.
+ */
+void Poly::addTo(Poly& dest, bool subtract, int scale) const
+{
+    if (scale == 1)
+    {
+        dest.accumulate(*this, subtract);
+    }
+    else
+    {
+        dest.accumulate(product(Poly(scale)), subtract);
+    } // end if (scale == 1)
+} // end addTo(Poly&, bool, int)
+
+/**----------------------------------------------------------------------------
+ * Adds a multiple of this constant to a Poly, or subtracts it.
+ * @param dest  The Poly to add to.
+ * @param subtract  true to subtract; false to add.
+ * @param scale  The multiple of this constant to add or subtract.
+ * @pre None.
+ * @post dest has changed by scale times this constant.
+ */
+void PolyConstant::addTo(Poly& dest, bool subtract, int scale) const
+{
+    Poly term(static_cast<int>(static_cast<unsigned int>(value)
+                               * static_cast<unsigned int>(scale)));
+
+    if (subtract)
+    {
+        dest -= term;
+    }
+    else
+    {
+        dest += term;
+    } // end if (subtract)
+} // end addTo(Poly&, bool, int)
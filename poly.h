@@ -11,7 +11,15 @@
  *          readable representation of the polynomial to an ostream. Operators
  *          are overloaded for addition, subtraction, multiplication,
  *          assignment (including combined with the previous three), equality,
- *          and iostreams.
+ *          and iostreams. +, - and scalar * build lazy expressions that are
+ *          evaluated in one pass when assigned; see polyexpr.h. Lists of up to
+ *          INLINE_CAPACITY coefficients are kept in a buffer inside the Poly
+ *          itself, so constants and other small polynomials never touch the
+ *          heap. A Poly whose coefficients are mostly 0 switches to storing
+ *          just its non-zero terms in a SparsePoly, and switches back when it
+ *          fills in again; see setDensityThreshold(). A list written by
+ *          serialize() can also be used straight from its file; see mapFile().
+ *          Callers see the same behavior whatever the storage.
  * @author  Brendan Sweeney, SID 1161837
  * @date    January 11, 2012
  */
@@ -20,18 +28,28 @@
 #define	_POLY_H
 
 #include <iostream>
+#include <utility>
+#include <vector>
+#include "polyexpr.h"
+#include "sparsepoly.h"
 
 using namespace std;
 
-class Poly
+class Poly : public PolyExpr<Poly>
 {
 public:
+
+    // largest coefficient list held inside the Poly instead of on the heap
+    static const int INLINE_CAPACITY = 8;
+
+    // largest power a Poly may hold, so that its length fits in an int
+    static const int MAX_POWER = SparsePoly::MAX_POWER;
     
     /**------------------------------------------------------------------------
-     * Default constructor. Creates a Poly of size 1 with the x^0 coefficient
-     * set to 0.
+     * Default constructor. Creates a Poly that represents 0, using the inline
+     * buffer for its coefficient list.
      * @pre None.
-     * @post Poly has size 1 and its first element is 0
+     * @post Poly has degree -1 and represents 0.
      */
     Poly();
 
@@ -40,7 +58,8 @@ public:
      * coefficient set to a specified value.
      * @param coeff  The coefficient of the x^0 value.
      * @pre None.
-     * @post Poly has size 1 and its first element is equal to coeff.
+     * @post Poly has degree 0 and its first element is equal to coeff, or
+     *       degree -1 if coeff is 0.
      */
     Poly(int coeff);
     
@@ -52,7 +71,9 @@ public:
      *             largest exponent. Only the absolute value of exp is used.
      * @pre None.
      * @post Poly has size greater than exp and its last element is equal to
-     *       coeff. any earlier elements are equal to 0.
+     *       coeff. any earlier elements are equal to 0. A single term of a
+     *       large power starts out in the sparse form. A power above
+     *       MAX_POWER cannot be held, and the Poly represents 0 instead.
      */
     Poly(int coeff, int exp);
 
@@ -65,50 +86,69 @@ public:
     Poly(const Poly& orig);
 
     /**------------------------------------------------------------------------
-     * Destructor. Sets each element to 0 before deleting the array. size is
-     * set to 0 and the pointer coeffList is set to NULL for uniformity.
+     * Move constructor. Creates a Poly that takes over the coefficient list
+     * of a temporary instead of copying it. A list held in the inline buffer
+     * cannot be taken, so it is copied; it has no more than INLINE_CAPACITY
+     * elements.
+     * @param orig  The Poly whose coefficient list is taken.
+     * @pre None.
+     * @post The new Poly holds the polynomial that orig held. orig is empty,
+     *       which represents 0.
+     */
+    Poly(Poly&& orig) noexcept;
+
+    /**------------------------------------------------------------------------
+     * Destructor. Sets each element to 0 before deleting the array, unless
+     * it is the inline buffer. size is set to 0 and the pointer coeffList is
+     * set to NULL for uniformity. A mapped list is left as it is, since
+     * clearing it would copy every page of the mapping only to release them.
      * @pre None.
      * @post All allocated resources are returned to the system.
      */
     virtual ~Poly();
-    
+
     /**------------------------------------------------------------------------
-     * Overloaded + operator. Adds this Poly to another and returns the result.
-     * @param rhs  The Poly to be added to this one.
+     * Expression constructor. Creates a Poly holding the value of an
+     * expression built by +, - and scalar *; see polyexpr.h.
+     * @param expr  The expression to evaluate.
      * @pre None.
-     * @post This Poly and rhs remain unchanged.
-     * @return A Poly that is the sum of this one and rhs.
+     * @post Poly represents the value of expr.
      */
-    Poly operator+(const Poly& rhs) const;
+    template <class E>
+    Poly(const PolyExpr<E>& expr);
     
     /**------------------------------------------------------------------------
-     * Overloaded - operator. Subtracts another Poly from this one and returns
-     * the result.
-     * @param rhs  The Poly to be subtracted from this one.
+     * Overloaded = operator. Sets this Poly to the same values as another one.
+     * @param rhs  The original Poly to copy.
      * @pre None.
-     * @post This Poly and rhs remain unchanged.
-     * @return A Poly that is the difference between this one and rhs.
+     * @post This Poly is equal to rhs.
+     * @return A reference to this Poly.
      */
-    Poly operator-(const Poly& rhs) const;
-    
+    Poly& operator=(const Poly& rhs);
+
     /**------------------------------------------------------------------------
-     * Overloaded * operator. Multiplies this Poly with another one and returns
-     * the result.
-     * @param rhs  The Poly to be multiplied with this one.
+     * Overloaded = operator for temporaries. Takes over the coefficient list
+     * of another Poly instead of copying it.
+     * @param rhs  The Poly whose coefficient list is taken.
      * @pre None.
-     * @post This Poly and rhs remain unchanged.
-     * @return A poly that is the product of this one and rhs.
+     * @post This Poly holds the polynomial that rhs held. rhs is empty, which
+     *       represents 0.
+     * @return A reference to this Poly.
      */
-    Poly operator*(const Poly& rhs) const;
-    
+    Poly& operator=(Poly&& rhs) noexcept;
+
     /**------------------------------------------------------------------------
-     * Overloaded = operator. Sets this Poly to the same values as another one.
-     * @param rhs  The original Poly to copy.
+     * Overloaded = operator for expressions. Evaluates an expression built by
+     * +, - and scalar * straight into the coefficient list, one power at a
+     * time, with no intermediate Poly. The list is reused if it is large
+     * enough. This Poly may appear in the expression.
+     * @param expr  The expression to evaluate.
      * @pre None.
-     * @post This Poly is equal to rhs.
+     * @post This Poly represents the value expr had before the assignment.
      * @return A reference to this Poly.
      */
-    Poly& operator=(const Poly& rhs);
+    template <class E>
+    Poly& operator=(const PolyExpr<E>& expr);
     
     /**------------------------------------------------------------------------
      * Overloaded += operator. Adds another Poly to this one.
@@ -118,6 +158,17 @@ public:
      * @return A reference to this Poly, the sum of the input.
      */
     Poly& operator+=(const Poly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Overloaded += operator for expressions. Adds an expression to this Poly
+     * in the same single pass as operator=.
+     * @param expr  The expression to be added to this Poly.
+     * @pre None.
+     * @post The value of expr has been added to this Poly.
+     * @return A reference to this Poly, the sum of the input.
+     */
+    template <class E>
+    Poly& operator+=(const PolyExpr<E>& expr);
     
     /**------------------------------------------------------------------------
      * Overloaded -= operator. Subtracts another Poly from this one.
@@ -127,19 +178,136 @@ public:
      * @return A reference to this Poly, the difference of the input.
      */
     Poly& operator-=(const Poly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Overloaded -= operator for expressions. Subtracts an expression from
+     * this Poly in the same single pass as operator=.
+     * @param expr  The expression to be subtracted from this Poly.
+     * @pre None.
+     * @post The value of expr has been subtracted from this Poly.
+     * @return A reference to this Poly, the difference of the input.
+     */
+    template <class E>
+    Poly& operator-=(const PolyExpr<E>& expr);
     
     /**------------------------------------------------------------------------
-     * Overloaded *= operator. Multiplies another Poly with this one.
+     * Overloaded *= operator. Multiplies another Poly with this one, using the
+     * same kernels as operator*. Dense products are written back into the
+     * coefficient list when it has room, without allocating; otherwise the
+     * list grows to at least twice its capacity, so a run of *= reallocates
+     * only now and then. An expression on the right is evaluated into a Poly
+     * first.
      * @param rhs  The Poly to be multiplied with this one.
      * @pre None.
      * @post The polynomial value of rhs has been multiplied with this Poly.
      * @return A reference to this Poly, the product of the input.
      */
     Poly& operator*=(const Poly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Squares this Poly with the square kernels, which need about half the
+     * multiplications of a general product; see square() in polymul.h.
+     * A * A and A *= A take the same path.
+     * @pre None.
+     * @post This Poly remains unchanged.
+     * @return A Poly that is the square of this one.
+     */
+    Poly square() const;
+
+    /**------------------------------------------------------------------------
+     * Raises this Poly to a power by repeated squaring: the bits of n are
+     * read from the top, squaring the result for each and multiplying it by
+     * this Poly for each set bit. That takes about log2(n) squares and as
+     * many products with the short original, instead of n - 1 products, and
+     * all of them run in place through *=, reusing the result's list.
+     * @param n  The power to raise this Poly to.
+     * @pre The degree of the result, n times the degree of this Poly, fits
+     *      in an int.
+     * @post This Poly remains unchanged.
+     * @return A Poly that is this one to the power n; 1 if n is 0.
+     */
+    Poly pow(unsigned int n) const;
+
+    /**------------------------------------------------------------------------
+     * Evaluates this Poly at many points at once, wrapping around modulo
+     * 2^32 like the rest of the arithmetic. Few points or short lists use
+     * Horner's rule over a vector of points in lockstep; many points on a
+     * long list use a subproduct tree, which takes about log2 of the number
+     * of points products and divisions instead of one pass per point; see
+     * evaluatePoints() in polyeval.h. A sparse Poly sums its terms, raising
+     * each point to their powers by repeated squaring.
+     * @param points  The points to evaluate at.
+     * @pre None.
+     * @post This Poly remains unchanged.
+     * @return The values at the points, in the same order.
+     */
+    vector<int> evaluateMany(const vector<int>& points) const;
+
+    /**------------------------------------------------------------------------
+     * Evaluates this Poly at a point, wrapping around modulo 2^32 like the
+     * rest of the arithmetic. The coefficients are split into one chain
+     * per vector lane, evaluated in lockstep and joined with Estrin's
+     * scheme; see evalCoeffs() in polysimd.h. A sparse Poly sums its terms.
+     * @param x  The point to evaluate at.
+     * @pre None.
+     * @post This Poly remains unchanged.
+     * @return The value at x, wrapped around to 32 bits.
+     */
+    int evaluate(int x) const;
+
+    /**------------------------------------------------------------------------
+     * Evaluates this Poly at a point exactly, checking for overflow. The
+     * value is found with Horner's rule in 64 bits. Once the running value
+     * passes 2^31 in size while x is neither -1, 0 nor 1, every later step
+     * at least doubles it, so the evaluation stops there.
+     * @param x  The point to evaluate at.
+     * @param value  The int to receive the value.
+     * @pre None.
+     * @post value holds the value at x if it fits in an int; otherwise it
+     *       is unchanged.
+     * @return true if the value at x fits in an int; false, otherwise.
+     */
+    bool evaluate(int x, int& value) const;
+
+    /**------------------------------------------------------------------------
+     * Evaluates this Poly at a point modulo a number, reading coefficients
+     * as signed. The reduced coefficients are joined in pairs with x, the
+     * pairs in pairs with x^2 and so on, by Estrin's scheme, so the
+     * multiplications of each round are independent of one another.
+     * @param x  The point to evaluate at.
+     * @param mod  The modulus.
+     * @pre mod is greater than 0.
+     * @post This Poly remains unchanged.
+     * @return The value at x modulo mod, from 0 to mod - 1.
+     */
+    int evaluateMod(int x, int mod) const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded /= operator. Divides this Poly by another one and keeps the
+     * quotient; see divmod().
+     * @param rhs  The divisor. May be this Poly.
+     * @pre None.
+     * @post This Poly holds the quotient, or 0 if rhs has an even leading
+     *       coefficient or is 0.
+     * @return A reference to this Poly, the quotient of the input.
+     */
+    Poly& operator/=(const Poly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Overloaded %= operator. Divides this Poly by another one and keeps the
+     * remainder; see divmod().
+     * @param rhs  The divisor. May be this Poly.
+     * @pre None.
+     * @post This Poly holds the remainder, or is unchanged if rhs has an
+     *       even leading coefficient or is 0.
+     * @return A reference to this Poly, the remainder of the input.
+     */
+    Poly& operator%=(const Poly& rhs);
     
     /**------------------------------------------------------------------------
      * Overloaded == operator. Tests if the polynomial represented by this Poly
-     * is equivalet to the polynomial represented by another Poly. Calls
+     * is equivalet to the polynomial represented by another Poly. Poly
+     * objects of different degrees are rejected at once; otherwise calls
      * compare().
      * @param rhs  The Poly to compare with this one.
      * @pre None.
@@ -170,6 +338,16 @@ public:
      *         the coefficient list; 0, otherwise.
      */
     int getCoeff(int exp) const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for the degree of this Poly. Kept current by every mutator and
+     * operator, so it takes constant time.
+     * @pre None.
+     * @post None.
+     * @return The largest power with a non-zero coefficient, or -1 if this
+     *         Poly represents 0.
+     */
+    int degree() const;
     
     /**------------------------------------------------------------------------
      * Mutator to set an element of the coefficient list.
@@ -180,16 +358,132 @@ public:
      * @post This Poly has the identified power set to the specified
      *       coefficient. If the identified power was outside of the range of
      *       the coefficient list, the list is expanded to accommodate it and
-     *       all other new elements are set to 0.
+     *       all other new elements are set to 0. The allocation at least
+     *       doubles whenever it has to grow, so setting powers in ascending
+     *       order takes amortized constant time per call. A power above
+     *       MAX_POWER cannot be held and leaves this Poly unchanged.
      */
     void setCoeff(int coeff, int exp);
 
+    /**------------------------------------------------------------------------
+     * Ensures that the coefficient list has room for a number of elements
+     * without being reallocated. Useful before setting many coefficients one-
+     * at-a-time.
+     * @param count  The number of elements (one more than the largest power)
+     *               that should fit in the coefficient list.
+     * @pre None.
+     * @post This Poly can hold powers up to count - 1 without reallocating.
+     *       The polynomial it represents is unchanged. Has no effect while
+     *       this Poly is in the sparse form.
+     */
+    void reserve(int count);
+
+    /**------------------------------------------------------------------------
+     * Accessor for the storage form of this Poly.
+     * @pre None.
+     * @post None.
+     * @return true if this Poly currently stores a list of terms; false, if
+     *         it stores a coefficient for every power.
+     */
+    bool isSparse() const;
+
+    /**------------------------------------------------------------------------
+     * Mutator for the fill ratio at which Poly objects switch between the
+     * dense and sparse forms. A Poly spanning at least 64 powers becomes
+     * sparse when fewer than this fraction of its coefficients are non-zero,
+     * and becomes dense again once twice that fraction are.
+     * @param threshold  The new fill ratio, between 0 and 1. 0 keeps every
+     *                   Poly dense.
+     * @pre None.
+     * @post Poly objects adapt to the new threshold the next time they
+     *       change.
+     */
+    static void setDensityThreshold(double threshold);
+
+    /**------------------------------------------------------------------------
+     * Accessor for the fill ratio at which Poly objects switch forms.
+     * @pre None.
+     * @post None.
+     * @return The fraction of non-zero coefficients below which a Poly is
+     *         sparse.
+     */
+    static double getDensityThreshold();
+
+    /**------------------------------------------------------------------------
+     * Writes this Poly to a stream in the binary format of polyserial.h: a
+     * header, then the coefficient list if dense or the terms if sparse,
+     * each coefficient at the narrowest width that holds them all. The whole
+     * encoding goes to the stream in one write.
+     * @param output  The stream to write to; opened in binary mode.
+     * @param mappable  true to write a dense Poly at 4 bytes per coefficient
+     *                  whatever they hold, so that mapFile() can use its
+     *                  coefficient list where it lies in the file.
+     * @pre None.
+     * @post output holds the encoding. This Poly remains unchanged.
+     * @return true if output is still good after the write; false,
+     *         otherwise.
+     */
+    bool serialize(ostream& output, bool mappable = false) const;
+
+    /**------------------------------------------------------------------------
+     * Reads a Poly written by serialize() from a stream. A dense body is
+     * read straight into the coefficient list and widened in place; a sparse
+     * one has its powers decoded from varints into the term list. Neither
+     * is parsed term by term.
+     * @param input  The stream to read from; opened in binary mode.
+     * @pre None.
+     * @post This Poly holds the polynomial read, in the form that suits its
+     *       fill ratio. If the stream ran out or held no valid encoding,
+     *       failbit is set on input and this Poly is unchanged.
+     * @return true if a Poly was read; false, otherwise.
+     */
+    bool deserialize(istream& input);
+
+    /**------------------------------------------------------------------------
+     * Loads a Poly written by serialize() from a file without copying its
+     * coefficients into a new list: the list is mapped from the file, read
+     * once to check its terms against the header, and getCoeff(),
+     * evaluation and the const operators then read it where it lies. The
+     * mapping is private and copy-on-write, so changing this Poly copies
+     * only the pages it writes and never the file; growing it past the
+     * mapped list moves it to the heap. A body that is sparse, narrower than
+     * 4 bytes (see serialize()), not 4-byte aligned in the file, or on a
+     * machine that cannot map it is read with deserialize() instead.
+     * @param path  The name of the file.
+     * @param offset  The position in the file at which the Poly starts.
+     * @pre The file is not changed while this Poly maps it.
+     * @post This Poly holds the polynomial in the file. If the file could
+     *       not be read or held no valid encoding there, this Poly is
+     *       unchanged.
+     * @return true if a Poly was loaded; false, otherwise.
+     */
+    bool mapFile(const char *path, long long offset = 0);
+
+    /**------------------------------------------------------------------------
+     * Accessor for the storage of the coefficient list.
+     * @pre None.
+     * @post None.
+     * @return true if the coefficient list is mapped from a file; false,
+     *         otherwise.
+     */
+    bool isMapped() const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for the number of non-zero coefficients.
+     * @pre None.
+     * @post None.
+     * @return The number of non-zero coefficients in either form.
+     */
+    int termCount() const;
+
     /**------------------------------------------------------------------------
      * Overloaded << operator. Writes the contents of this Poly to an ostream.
      * Only elements with a non-zero coefficient are displayed. x is displayed
      * for all powers greater than 0. For powers greater than 1, x is shown as
      * x^y, where y is the power. Positive value are prefixed with +. If there
-     * are no elements to display, " 0" is written out.
+     * are no elements to display, " 0" is written out. The text is rendered
+     * into one buffer with formatTerm() (see polyformat.h) and written to
+     * the stream in one call.
      * @param output  The ostream to which to write out the polynomial.
      * @param source  The Poly from which to read a coefficient list (usually
      *                this Poly).
@@ -218,26 +512,481 @@ public:
      */
     friend istream& operator>>(istream&, Poly&);
 
+    /**------------------------------------------------------------------------
+     * Reads a coefficient list from a character buffer, in the same
+     * "coeff exp ... 0 0" text that operator>> reads, without going through
+     * a stream. Integers are decoded by hand with runs of digits found a
+     * vector of bytes at a time, and the pairs are placed in storage sized
+     * once for all of them; see scanTerms() in polyparse.h. Meant for
+     * large inputs read or mapped into memory whole; call it again from
+     * the position returned to read the next Poly.
+     * @param begin  The first character to read.
+     * @param end  One past the last character that may be read.
+     * @param target  The Poly to receive the coefficient list.
+     * @pre begin is no greater than end.
+     * @post target holds the pairs read, as if each were set in turn with
+     *       setCoeff(), including those read before a failure.
+     * @return One past the last digit of the terminating 0 0, or NULL if
+     *         the buffer ran out, held something other than integers or
+     *         held a power of INT_MAX or -INT_MAX first.
+     */
+    friend const char *parsePoly(const char *begin, const char *end,
+                                 Poly& target);
+
+    /**------------------------------------------------------------------------
+     * Overloaded * operator. Multiplies two polynomials and returns the
+     * result. Large operands are multiplied with Karatsuba's algorithm or the
+     * number-theoretic transform; see multiply() in polymul.h. If either
+     * operand is sparse, only its terms are multiplied. Unlike + and -, the
+     * product is computed at once, since each of its coefficients depends on
+     * many of the operands'. An operand that is an expression is evaluated
+     * into a Poly first; multiplying by an int builds a scaled expression
+     * instead (see polyexpr.h).
+     * @param lhs  The first factor.
+     * @param rhs  The second factor.
+     * @pre None.
+     * @post lhs and rhs remain unchanged.
+     * @return A Poly that is the product of lhs and rhs.
+     */
+    template <class L, class R>
+    friend Poly operator*(const PolyExpr<L>& lhs, const PolyExpr<R>& rhs);
+
+    /**------------------------------------------------------------------------
+     * Truncated product. Multiplies two polynomials but computes only the
+     * coefficients below x^n, as power-series arithmetic needs, with the
+     * short-product kernels; see mulLow() in polymul.h. That costs from about
+     * half of a full product with the schoolbook loop to about 80 percent
+     * with Karatsuba's algorithm. If either operand is sparse, the terms at
+     * or above x^n are dropped from both before they are multiplied.
+     * @param lhs  The first factor.
+     * @param rhs  The second factor. May be lhs.
+     * @param n  The number of powers to keep. Values below 1 give 0.
+     * @pre None.
+     * @post lhs and rhs remain unchanged.
+     * @return A Poly that is the product of lhs and rhs modulo x^n.
+     */
+    friend Poly mullo(const Poly& lhs, const Poly& rhs, int n);
+
+    /**------------------------------------------------------------------------
+     * Divides one polynomial by another, giving a quotient and a remainder
+     * of lower degree than the divisor. Coefficients wrap around modulo
+     * 2^32, where only odd numbers can be divided by, so the divisor must
+     * have an odd leading coefficient. Short quotients or divisors use long
+     * division; longer ones find the quotient by Newton iteration with the
+     * fast multiplication kernels, at a small multiple of the cost of one
+     * product; see divide() in polydiv.h. Sparse operands are divided in
+     * the dense form.
+     * @param num  The dividend.
+     * @param den  The divisor.
+     * @param quot  The Poly to receive the quotient. May be num or den.
+     * @param rem  The Poly to receive the remainder. May be num or den, but
+     *             not quot.
+     * @pre None.
+     * @post If den is not 0 and its leading coefficient is odd, num is quot
+     *       * den + rem and rem has a lower degree than den. Otherwise quot
+     *       is 0 and rem is num.
+     * @return true if the division was made; false if den is 0 or has an
+     *         even leading coefficient.
+     */
+    friend bool divmod(const Poly& num, const Poly& den, Poly& quot,
+                       Poly& rem);
+
+    /**------------------------------------------------------------------------
+     * Overloaded / operator. Divides one polynomial by another and returns
+     * the quotient; see divmod().
+     * @param num  The dividend.
+     * @param den  The divisor.
+     * @pre None.
+     * @post num and den remain unchanged.
+     * @return The quotient, or 0 if den has an even leading coefficient or
+     *         is 0.
+     */
+    friend Poly operator/(const Poly& num, const Poly& den);
+
+    /**------------------------------------------------------------------------
+     * Overloaded % operator. Divides one polynomial by another and returns
+     * the remainder; see divmod().
+     * @param num  The dividend.
+     * @param den  The divisor.
+     * @pre None.
+     * @post num and den remain unchanged.
+     * @return The remainder, or num if den has an even leading coefficient
+     *         or is 0.
+     */
+    friend Poly operator%(const Poly& num, const Poly& den);
+
 private:
-    
+
+    // reads coeffList directly when converting to the sparse form
+    friend class SparsePoly;
+
+    // expression nodes read their Poly operands through the leaf interface
+    template <class L, class R> friend class PolySum;
+    template <class L, class R> friend class PolyDifference;
+    template <class E> friend class PolyScaled;
+
     /**------------------------------------------------------------------------
-     * Compares the coefficient list of two Poly objects of possibly different
-     * sizes. They are considered equivalent if all the elements in the smaller
-     * Poly match the beginning elements in the larger Poly and all of the
-     * later elements in the larger Poly are equal to 0.
-     * @param smaller  The Poly with the smaller size. May be the same as
-     *                 larger, but cannot be greater.
-     * @param larger  The Poly with the larger size. May be the same as
-     *                smaller, but cannot be less.
-     * @pre The size of smaller is less than or equal to the size of larger.
-     * @post smaller and larger remain unchanged.
-     * @return true if both parameters represent equivalent polynomials; false,
-     *         otherwise.
+     * Multiplies this Poly with another one; the body of operator*.
+     * @param rhs  The Poly to be multiplied with this one. May be this Poly.
+     * @pre None.
+     * @post This Poly and rhs remain unchanged.
+     * @return A Poly that is the product of this one and rhs.
+     */
+    Poly product(const Poly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Copies the terms of this Poly below a power.
+     * @param n  The number of powers to keep. Values below 1 give 0.
+     * @pre None.
+     * @post This Poly remains unchanged.
+     * @return A Poly that is this one modulo x^n.
+     */
+    Poly truncated(int n) const;
+
+    /**------------------------------------------------------------------------
+     * Evaluates the terms of a sparse Poly at a point, raising x from one
+     * term's power to the next by repeated squaring.
+     * @param x  The point to evaluate at.
+     * @pre This Poly is in the sparse form.
+     * @post This Poly remains unchanged.
+     * @return The value at x, wrapped around to 32 bits.
+     */
+    int sumTerms(int x) const;
+
+    /**------------------------------------------------------------------------
+     * Replaces the polynomial with the one given by a list of coefficient
+     * and power pairs, as if each pair were set in turn with setCoeff().
+     * The storage is sized and its form chosen once, from the largest
+     * power and the number of non-zero coefficients, rather than grown
+     * pair by pair.
+     * @param pairs  The pairs, coefficient first.
+     * @param count  The number of pairs.
+     * @pre pairs has 2 * count elements.
+     * @post This Poly holds the polynomial the pairs describe. A pair whose
+     *       power has no absolute value in an int is skipped.
      */
-    bool compare(const Poly& smaller, const Poly& larger) const;
+    void assignPairs(const int *pairs, int count);
+
+    /**------------------------------------------------------------------------
+     * Orders terms by power alone, so that a stable sort keeps terms of the
+     * same power in the order they were given.
+     * @param lhs  The first term.
+     * @param rhs  The second term.
+     * @pre None.
+     * @post None.
+     * @return true if lhs has the lower power; false, otherwise.
+     */
+    static bool lowerPower(const SparsePoly::Term& lhs,
+                           const SparsePoly::Term& rhs);
+
+    /**------------------------------------------------------------------------
+     * Evaluates an expression into this Poly; the body of the expression
+     * constructor and assignment operators. Dense operands are combined in
+     * one pass over the powers of the result, written into a new list only
+     * if the current one is too small. If any operand is sparse, the
+     * expression is instead accumulated operand by operand into a new Poly,
+     * which then replaces this one.
+     * @param expr  The expression to evaluate. May refer to this Poly.
+     * @pre None.
+     * @post This Poly represents the value expr had before the call.
+     */
+    template <class E>
+    void assign(const E& expr);
+
+    /**------------------------------------------------------------------------
+     * Accessor for a coefficient as an expression leaf.
+     * @param i  The power whose coefficient is sought; not negative.
+     * @pre This Poly is dense.
+     * @post None.
+     * @return The coefficient of x^i; 0 beyond the coefficient list.
+     */
+    int coeff(int i) const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for the storage form as an expression leaf.
+     * @pre None.
+     * @post None.
+     * @return true if this Poly is sparse; false, otherwise.
+     */
+    bool hasSparse() const;
+
+    /**------------------------------------------------------------------------
+     * Adds a multiple of this Poly to another one, or subtracts it; the
+     * expression leaf's part in evaluating an expression with a sparse
+     * operand.
+     * @param dest  The Poly to add to. Not this Poly.
+     * @param subtract  true to subtract; false to add.
+     * @param scale  The multiple of this Poly to add or subtract.
+     * @pre None.
+     * @post dest has changed by scale times this Poly.
+     */
+    void addTo(Poly& dest, bool subtract, int scale) const;
     
+    /**------------------------------------------------------------------------
+     * Compares the coefficient lists of two dense Poly objects of the same
+     * degree element by element.
+     * @param lhs  The first Poly.
+     * @param rhs  The second Poly. May be the same as lhs.
+     * @pre Both are dense and have the same size.
+     * @post lhs and rhs remain unchanged.
+     * @return true if both parameters represent equivalent polynomials;
+     *         false, otherwise.
+     */
+    bool compare(const Poly& lhs, const Poly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for the number of powers this Poly spans.
+     * @pre None.
+     * @post None.
+     * @return One more than the largest power stored.
+     */
+    int length() const;
+
+    /**------------------------------------------------------------------------
+     * Decides whether a polynomial with a given number of terms over a given
+     * span of powers is better kept in the sparse form.
+     * @param count  The number of non-zero coefficients.
+     * @param length  One more than the largest power.
+     * @pre None.
+     * @post None.
+     * @return true if the fill ratio is below the density threshold or the
+     *         span is too long for a coefficient list; false, otherwise.
+     */
+    static bool prefersSparse(long long count, long long length);
+
+    /**------------------------------------------------------------------------
+     * Recounts the non-zero coefficients of the dense list.
+     * @pre This Poly is dense.
+     * @post nonzero matches the coefficient list.
+     */
+    void countTerms();
+
+    /**------------------------------------------------------------------------
+     * Drops 0 elements from the top of the dense list so that its last
+     * element, if any, is the leading coefficient.
+     * @pre This Poly is dense.
+     * @post size is one more than the degree of this Poly.
+     */
+    void trim();
+
+    /**------------------------------------------------------------------------
+     * Switches to the sparse form if the fill ratio has fallen below the
+     * density threshold, or back to the dense form once it has reached twice
+     * that. The gap between the two keeps a Poly from switching back and
+     * forth while it is built term by term.
+     * @pre nonzero is current.
+     * @post This Poly is in the form that suits its fill ratio.
+     */
+    void adapt();
+
+    /**------------------------------------------------------------------------
+     * Converts this Poly to the sparse form and releases the coefficient
+     * list.
+     * @pre None.
+     * @post This Poly is sparse and represents the same polynomial.
+     */
+    void makeSparse();
+
+    /**------------------------------------------------------------------------
+     * Converts this Poly to the dense form and releases the term list.
+     * @pre None.
+     * @post This Poly is dense and represents the same polynomial.
+     */
+    void makeDense();
+
+    /**------------------------------------------------------------------------
+     * Adds another Poly to this one or subtracts it, using whichever form
+     * suits the result. Sparse results are found by merging term lists;
+     * dense results by adding the coefficient lists with the vector kernels
+     * in polysimd.h, or by adding just the terms when rhs is sparse.
+     * @param rhs  The Poly to be added or subtracted. May be this Poly.
+     * @param subtract  true to subtract rhs; false to add it.
+     * @pre None.
+     * @post This Poly holds the sum or difference.
+     */
+    void accumulate(const Poly& rhs, bool subtract);
+
+    /**------------------------------------------------------------------------
+     * Adds a value to one element of the dense coefficient list, or
+     * subtracts it, wrapping around on overflow.
+     * @param exp  The power (index) of the element.
+     * @param coeff  The value to add or subtract.
+     * @param subtract  true to subtract coeff; false to add it.
+     * @pre This Poly is dense and exp is less than size.
+     * @post The element has changed by coeff and nonzero is current.
+     */
+    void addTerm(int exp, int coeff, bool subtract);
+
+    /**------------------------------------------------------------------------
+     * Multiplies a dense Poly with a sparse one. If the product is expected
+     * to be sparse, the dense operand is converted to terms first; otherwise
+     * each term adds a shifted, scaled copy of the dense list into a dense
+     * product.
+     * @param dense  The dense operand.
+     * @param sparse  The sparse operand.
+     * @param prod  The Poly to receive the product.
+     * @pre prod is a default-constructed Poly, which is 0.
+     * @post prod holds the product, not yet adapted to its fill ratio.
+     */
+    static void mulMixed(const Poly& dense, const Poly& sparse, Poly& prod);
+
+    /**------------------------------------------------------------------------
+     * Multiplies two sparse Polys. Every term of one is paired with every
+     * term of the other, unless the pairs would cost more than densifying
+     * both operands and multiplying the coefficient lists with multiply().
+     * @param lhs  The first operand.
+     * @param rhs  The second operand. May be lhs, which is squared.
+     * @param prod  The Poly to receive the product.
+     * @pre lhs and rhs are sparse. prod is a default-constructed Poly, which
+     *      is 0.
+     * @post prod holds the product, not yet adapted to its fill ratio. Terms
+     *       whose power would be above SparsePoly::MAX_POWER are dropped.
+     */
+    static void mulSparse(const Poly& lhs, const Poly& rhs, Poly& prod);
+
+    /**------------------------------------------------------------------------
+     * Frees the coefficient list if it was allocated on the heap, or unmaps
+     * it if it was mapped from a file, and falls back to the inline buffer.
+     * Elements are not preserved.
+     * @pre None.
+     * @post coeffList is the inline buffer and capacity is INLINE_CAPACITY.
+     */
+    void releaseList();
+
+    static double densityThreshold;     // see setDensityThreshold()
+
     int *coeffList;
-    int size;
+    int size;           // elements in use; one more than the degree
+    int capacity;       // elements allocated
+    int nonzero;        // non-zero elements, while dense
+    SparsePoly terms;   // the polynomial, while sparse
+    bool sparse;        // true if terms is in use instead of coeffList
+    bool mapped;        // true if coeffList lies in a mapping of a file
+    int local[INLINE_CAPACITY]; // coeffList while it fits
 };
 
+/**----------------------------------------------------------------------------
+ * Evaluates an operand of operator* into a Poly; a Poly is passed through.
+ * @param expr  The operand.
+ * @pre None.
+ * @post None.
+ * @return The value of expr.
+ */
+inline const Poly& materialize(const Poly& expr)
+{
+    return expr;
+} // end materialize(const Poly&)
+
+template <class E>
+inline Poly materialize(const PolyExpr<E>& expr)
+{
+    return Poly(expr);
+} // end materialize(const PolyExpr<E>&)
+
+template <class L, class R>
+inline Poly operator*(const PolyExpr<L>& lhs, const PolyExpr<R>& rhs)
+{
+    const Poly& left = materialize(lhs.self());
+    const Poly& right = materialize(rhs.self());
+
+    return left.product(right);
+} // end operator*(const PolyExpr<L>&, const PolyExpr<R>&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded == and != operators for an expression on the left; a Poly on the
+ * left uses the members. The expression is evaluated, as is rhs if it is not
+ * already a Poly, then the two are compared as Poly objects.
+ * @param lhs  The first operand.
+ * @param rhs  The second operand.
+ * @pre None.
+ * @post lhs and rhs remain unchanged.
+ * @return true if the two represent the same polynomial (==) or different
+ *         ones (!=); false, otherwise.
+ */
+template <class L>
+inline bool operator==(const PolyExpr<L>& lhs, const Poly& rhs)
+{
+    return rhs == materialize(lhs.self());
+} // end operator==(const PolyExpr<L>&, const Poly&)
+
+template <class L>
+inline bool operator!=(const PolyExpr<L>& lhs, const Poly& rhs)
+{
+    return rhs != materialize(lhs.self());
+} // end operator!=(const PolyExpr<L>&, const Poly&)
+
+template <class E>
+Poly::Poly(const PolyExpr<E>& expr)
+    : coeffList(local), size(0), capacity(INLINE_CAPACITY), nonzero(0),
+      sparse(false), mapped(false)
+{
+    assign(expr.self());
+} // end Expression Constructor
+
+template <class E>
+Poly& Poly::operator=(const PolyExpr<E>& expr)
+{
+    assign(expr.self());
+    return *this;
+} // end operator=(const PolyExpr<E>&)
+
+template <class E>
+Poly& Poly::operator+=(const PolyExpr<E>& expr)
+{
+    assign(PolySum<Poly, E>(*this, expr.self()));
+    return *this;
+} // end operator+=(const PolyExpr<E>&)
+
+template <class E>
+Poly& Poly::operator-=(const PolyExpr<E>& expr)
+{
+    assign(PolyDifference<Poly, E>(*this, expr.self()));
+    return *this;
+} // end operator-=(const PolyExpr<E>&)
+
+template <class E>
+void Poly::assign(const E& expr)
+{
+    if (expr.hasSparse())
+    {
+        Poly result;
+
+        expr.addTo(result, false, 1);
+        *this = std::move(result);
+        return;
+    } // end if (expr.hasSparse())
+
+    // a sparse Poly is not part of expr, so its terms can go
+    if (sparse)
+    {
+        terms = SparsePoly();
+        sparse = false;
+        size = 0;
+    } // end if (sparse)
+
+    // every coefficient of expr depends only on the same power of each
+    // operand, so it can be written over the list it was read from
+    int count = expr.length();
+    int *list = count > capacity ? new int[count] : coeffList;
+    int filled = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        list[i] = expr.coeff(i);
+        filled += list[i] != 0;
+    } // end for (int i = 0)
+
+    if (list != coeffList)
+    {
+        releaseList();
+        coeffList = list;
+        capacity = count;
+    } // end if (list != coeffList)
+
+    size = count;
+    nonzero = filled;
+    trim();
+    adapt();
+} // end assign(const E&)
+
 #endif	/* _POLY_H */
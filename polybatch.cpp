@@ -0,0 +1,502 @@
+/**
+ * @file    polybatch.cpp
+ * @brief   Batch driver for Poly: reads jobs from a file or standard input,
+ *          one per line, runs them on a pool of threads and writes one line
+ *          of results per job, in the order read. A job is an operation and
+ *          its operands:
+ *
+ *              add a b     sub a b     mul a b     div a b     mod a b
+ *              eval a x1 x2 ...
+ *
+ *          where a and b are polynomials in the "coeff exp ... 0 0" text
+ *          that operator>> reads, or @name for a file written by
+ *          Poly::serialize(), which is mapped rather than read where it can
+ *          be. A Poly result is written as operator<< shows it, and eval
+ *          writes the value at each point, wrapped to 32 bits. A job that
+ *          cannot be read or run gives a line of "error", and the reason
+ *          goes to standard error; the jobs after it still run. Blank lines
+ *          and lines starting with # are skipped.
+ *
+ *          Jobs are read and run in batches, and each batch's results go to
+ *          the output in one write. At the end the number of jobs, operands
+ *          and terms read and the rates they were handled at are reported on
+ *          standard error.
+ *
+ *              usage: polybatch [-j threads] [-b batch] [input [output]]
+ *
+ *          input and output default to standard input and output, or - for
+ *          either. threads defaults to one per core, and batch to 4096 jobs.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "poly.h"
+#include "polyformat.h"
+#include "polymul.h"
+#include "polyparse.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// jobs read and run together before their results are written
+static const int DEFAULT_BATCH = 4096;
+
+// the operations a job may name, in the order of Operation
+static const char *const OPERATION_NAMES[] = { "add", "sub", "mul", "div",
+                                               "mod", "eval" };
+static const int OPERATION_COUNT = 6;
+
+// most coefficients a dividend may span; divmod() works on it as a dense
+// list however sparse it is, so a high power alone would take gigabytes
+static const int MAX_DIVIDEND = 1 << 26;
+
+enum Operation { ADD, SUB, MUL, DIV, MOD, EVAL };
+
+// one line of input and what became of it
+struct Job
+{
+    string line;            // the job as read
+    string result;          // the line to write for it, newline included
+    long long number;       // line number in the input
+    int polys;              // operands read
+    long long terms;        // non-zero coefficients in the operands
+    const char *error;      // why the job could not be read or run, or NULL
+};
+
+/**----------------------------------------------------------------------------
+ * Checks for the white space that separates the parts of a job.
+ * @param c  The character to check.
+ * @pre None.
+ * @post None.
+ * @return true if c is a space, tab, carriage return or similar; false,
+ *         otherwise.
+ */
+static bool isSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+} // end isSpace(char)
+
+/**----------------------------------------------------------------------------
+ * Skips white space.
+ * @param p  The first character to check.
+ * @param end  One past the last character that may be read.
+ * @pre p is no greater than end.
+ * @post None.
+ * @return The first character from p on that is not white space, or end.
+ */
+static const char *skipSpace(const char *p, const char *end)
+{
+    while (p < end && isSpace(*p))
+    {
+        ++p;
+    } // end while (p < end && isSpace(*p))
+
+    return p;
+} // end skipSpace(const char*, const char*)
+
+/**----------------------------------------------------------------------------
+ * Reads the operation that starts a job.
+ * @param p  The first character of the job.
+ * @param end  One past the last character of the job.
+ * @param operation  The int to receive the Operation.
+ * @pre p is no greater than end.
+ * @post operation holds the Operation if its name was found.
+ * @return One past the name, or NULL if the job starts with no known name.
+ */
+static const char *readOperation(const char *p, const char *end,
+                                 int& operation)
+{
+    const char *name = skipSpace(p, end);
+
+    p = name;
+
+    while (p < end && !isSpace(*p))
+    {
+        ++p;
+    } // end while (p < end && !isSpace(*p))
+
+    for (int i = 0; i < OPERATION_COUNT; ++i)
+    {
+        if (strlen(OPERATION_NAMES[i]) == static_cast<size_t>(p - name)
+            && strncmp(OPERATION_NAMES[i], name, p - name) == 0)
+        {
+            operation = i;
+            return p;
+        } // end if (strlen(OPERATION_NAMES[i]) == ...)
+    } // end for (int i = 0)
+
+    return NULL;
+} // end readOperation(const char*, const char*, int&)
+
+/**----------------------------------------------------------------------------
+ * Reads one operand of a job: coefficient and power pairs up to 0 0, or
+ * @ and the name of a file written by Poly::serialize().
+ * @param p  The first character of the operand, or white space before it.
+ * @param end  One past the last character of the job.
+ * @param operand  The Poly to receive the operand.
+ * @param job  The job, to count the operand in.
+ * @pre p is no greater than end.
+ * @post operand holds the operand if it was read, and job counts it.
+ * @return One past the operand, or NULL if it could not be read.
+ */
+static const char *readOperand(const char *p, const char *end, Poly& operand,
+                               Job& job)
+{
+    p = skipSpace(p, end);
+
+    if (p < end && *p == '@')
+    {
+        const char *name = ++p;
+
+        while (p < end && !isSpace(*p))
+        {
+            ++p;
+        } // end while (p < end && !isSpace(*p))
+
+        p = operand.mapFile(string(name, p).c_str()) ? p : NULL;
+    }
+    else
+    {
+        p = parsePoly(p, end, operand);
+    } // end if (p < end && *p == '@')
+
+    if (p != NULL)
+    {
+        ++job.polys;
+        job.terms += operand.termCount();
+    } // end if (p != NULL)
+
+    return p;
+} // end readOperand(const char*, const char*, Poly&, Job&)
+
+/**----------------------------------------------------------------------------
+ * Evaluates an operand at the points that end an eval job.
+ * @param p  The first character after the operand.
+ * @param end  One past the last character of the job.
+ * @param operand  The Poly to evaluate.
+ * @param job  The job, to receive the values.
+ * @pre p is no greater than end.
+ * @post job.result holds the value at each point read, each after a space.
+ * @return One past the last point read; anything else there is not a point.
+ */
+static const char *evaluateAt(const char *p, const char *end,
+                              const Poly& operand, Job& job)
+{
+    vector<int> points;
+    const char *next;
+    int x;
+
+    while ((next = scanInt(p, end, x)) != NULL)
+    {
+        points.push_back(x);
+        p = next;
+    } // end while ((next = scanInt(p, end, x)) != NULL)
+
+    vector<int> values = operand.evaluateMany(points);
+    char digits[12];
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        digits[0] = ' ';
+        job.result.append(digits, formatInt(digits + 1, values[i]));
+    } // end for (size_t i = 0)
+
+    return p;
+} // end evaluateAt(const char*, const char*, const Poly&, Job&)
+
+/**----------------------------------------------------------------------------
+ * Reads one job and checks its operands.
+ * @param job  The job, with its line read.
+ * @param operation  The int to receive the Operation.
+ * @param lhs  The Poly to receive the first operand.
+ * @param rhs  The Poly to receive the second operand, unless it is an eval.
+ * @pre None.
+ * @post The operands are read and counted in job, and job.result holds the
+ *       values of an eval.
+ * @return NULL if the job can run; otherwise, why it cannot.
+ */
+static const char *readJob(Job& job, int& operation, Poly& lhs, Poly& rhs)
+{
+    const char *p = job.line.data();
+    const char *end = p + job.line.size();
+
+    if ((p = readOperation(p, end, operation)) == NULL)
+    {
+        return "unknown operation";
+    } // end if ((p = readOperation(p, end, operation)) == NULL)
+
+    if ((p = readOperand(p, end, lhs, job)) == NULL)
+    {
+        return "cannot read the first operand";
+    } // end if ((p = readOperand(p, end, lhs, job)) == NULL)
+
+    if (operation == EVAL)
+    {
+        p = evaluateAt(p, end, lhs, job);
+    }
+    else if ((p = readOperand(p, end, rhs, job)) == NULL)
+    {
+        return "cannot read the second operand";
+    } // end if (operation == EVAL)
+
+    if (skipSpace(p, end) != end)
+    {
+        return "unexpected text after the operands";
+    } // end if (skipSpace(p, end) != end)
+
+    if ((operation == DIV || operation == MOD)
+        && lhs.degree() >= MAX_DIVIDEND)
+    {
+        return "dividend too long";
+    } // end if ((operation == DIV || operation == MOD) && ...)
+
+    return NULL;
+} // end readJob(Job&, int&, Poly&, Poly&)
+
+/**----------------------------------------------------------------------------
+ * Reads and runs one job.
+ * @param job  The job, with its line read.
+ * @pre None.
+ * @post job holds the result line and the operands counted, with error set
+ *       if the job could not be read or run.
+ */
+static void runJob(Job& job)
+{
+    Poly lhs, rhs, result;
+    int operation = ADD;
+
+    job.result.clear();
+    job.polys = 0;
+    job.terms = 0;
+    job.error = readJob(job, operation, lhs, rhs);
+
+    // divisors with an even leading coefficient have no quotient
+    Poly quot, rem;
+
+    if (job.error == NULL && (operation == DIV || operation == MOD)
+        && !divmod(lhs, rhs, quot, rem))
+    {
+        job.error = "divisor has an even leading coefficient";
+    } // end if (job.error == NULL && ...)
+
+    if (job.error != NULL)
+    {
+        job.result = "error\n";
+        return;
+    } // end if (job.error != NULL)
+
+    if (operation != EVAL)
+    {
+        ostringstream text;
+
+        switch (operation)
+        {
+        case ADD:
+            result = lhs + rhs;
+            break;
+        case SUB:
+            result = lhs - rhs;
+            break;
+        case MUL:
+            result = lhs * rhs;
+            break;
+        case DIV:
+            result = std::move(quot);
+            break;
+        default:
+            result = std::move(rem);
+            break;
+        } // end switch (operation)
+
+        text << result;
+        job.result = text.str();
+    } // end if (operation != EVAL)
+
+    job.result += '\n';
+} // end runJob(Job&)
+
+/**----------------------------------------------------------------------------
+ * Runs one job of a batch; the task given to the thread pool.
+ * @param context  The vector of jobs.
+ * @param index  The job to run.
+ * @pre index is within the vector.
+ * @post The job has run, or failed for want of memory.
+ */
+static void runTask(void *context, int index)
+{
+    Job& job = (*static_cast<vector<Job>*>(context))[index];
+
+    // a job too large for memory fails alone rather than ending the batch
+    try
+    {
+        runJob(job);
+    }
+    catch (const bad_alloc&)
+    {
+        job.error = "out of memory";
+        job.result = "error\n";
+    } // end try
+} // end runTask(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Reads a positive count given on the command line.
+ * @param text  The argument.
+ * @param value  The int to receive the count.
+ * @pre None.
+ * @post value holds the count if it was valid.
+ * @return true if text is a whole number greater than 0; false, otherwise.
+ */
+static bool readCount(const char *text, int& value)
+{
+    char *end;
+    long count = text == NULL ? 0 : strtol(text, &end, 10);
+
+    if (count < 1 || count > 1 << 24 || *end != '\0')
+    {
+        return false;
+    } // end if (count < 1 || count > 1 << 24 || *end != '\0')
+
+    value = static_cast<int>(count);
+    return true;
+} // end readCount(const char*, int&)
+
+/**----------------------------------------------------------------------------
+ * Reads the jobs, runs them in batches and reports the throughput.
+ * @param argc  The number of arguments, counting the program name.
+ * @param argv  The arguments; see the usage above.
+ * @pre None.
+ * @post Every job's result is written to the output, and the totals to
+ *       standard error.
+ * @return 0 if every job ran; 1 if any failed; 2 for bad arguments or files.
+ */
+int main(int argc, char *argv[])
+{
+    int threads = getThreadCount();
+    int batchSize = DEFAULT_BATCH;
+    const char *names[2] = { "-", "-" };
+    int named = 0;
+    bool usable = true;
+
+    for (int i = 1; i < argc && usable; ++i)
+    {
+        if (strcmp(argv[i], "-j") == 0)
+        {
+            usable = readCount(++i < argc ? argv[i] : NULL, threads);
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            usable = readCount(++i < argc ? argv[i] : NULL, batchSize);
+        }
+        else
+        {
+            usable = named < 2 && (argv[i][0] != '-' || argv[i][1] == '\0');
+
+            if (usable)
+            {
+                names[named++] = argv[i];
+            } // end if (usable)
+        } // end if (strcmp(argv[i], "-j") == 0)
+    } // end for (int i = 1; i < argc && usable)
+
+    if (!usable)
+    {
+        cerr << "usage: polybatch [-j threads] [-b batch] [input [output]]"
+             << endl;
+        return 2;
+    } // end if (!usable)
+
+    ios::sync_with_stdio(false);
+
+    ifstream inFile;
+    ofstream outFile;
+    istream& input = strcmp(names[0], "-") == 0 ? cin : inFile;
+    ostream& output = strcmp(names[1], "-") == 0 ? cout : outFile;
+
+    if (&input == &inFile)
+    {
+        inFile.open(names[0], ios::in | ios::binary);
+    } // end if (&input == &inFile)
+
+    if (&output == &outFile)
+    {
+        outFile.open(names[1], ios::out | ios::binary);
+    } // end if (&output == &outFile)
+
+    if (!input || !output)
+    {
+        cerr << "polybatch: cannot open "
+             << (!input ? names[0] : names[1]) << endl;
+        return 2;
+    } // end if (!input || !output)
+
+    // -j covers the kernels too, so that nothing starts threads beyond it
+    setThreadCount(threads);
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    vector<Job> jobs(batchSize);
+    long long number = 0, done = 0, polys = 0, terms = 0, failures = 0;
+    string text;
+
+    while (input)
+    {
+        int count = 0;
+
+        while (count < batchSize && getline(input, jobs[count].line))
+        {
+            const string& line = jobs[count].line;
+            size_t first = line.find_first_not_of(" \t\r\v\f");
+
+            jobs[count].number = ++number;
+
+            if (first != string::npos && line[first] != '#')
+            {
+                ++count;
+            } // end if (first != string::npos && line[first] != '#')
+        } // end while (count < batchSize && ...)
+
+        pool.run(count, runTask, &jobs);
+        text.clear();
+
+        for (int i = 0; i < count; ++i)
+        {
+            text += jobs[i].result;
+            polys += jobs[i].polys;
+            terms += jobs[i].terms;
+
+            if (jobs[i].error != NULL)
+            {
+                ++failures;
+                cerr << "polybatch: line " << jobs[i].number << ": "
+                     << jobs[i].error << endl;
+            } // end if (jobs[i].error != NULL)
+        } // end for (int i = 0)
+
+        output.write(text.data(), static_cast<streamsize>(text.size()));
+        done += count;
+    } // end while (input)
+
+    output.flush();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now()
+                                              - start).count();
+    double rate = seconds > 0 ? 1 / seconds : 0;
+
+    cerr << "polybatch: " << done << " jobs, " << polys << " polys, "
+         << terms << " terms in " << seconds << " s, threads: "
+         << pool.size() << endl
+         << "polybatch: " << static_cast<long long>(polys * rate)
+         << " polys/s, " << static_cast<long long>(terms * rate)
+         << " terms/s" << endl;
+
+    return !output ? 2 : failures > 0 ? 1 : 0;
+} // end main(int, char*[])
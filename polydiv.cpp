@@ -0,0 +1,290 @@
+/**
+ * @file    polydiv.cpp
+ * @brief   Division kernels for the coefficient arrays behind Poly. Each
+ *          kernel takes arrays of ints, where the index of an element is its
+ *          power, and arithmetic wraps around modulo 2^32 as it does
+ *          everywhere else in Poly. In that ring, a polynomial can be divided
+ *          by another exactly when the divisor's leading coefficient is odd,
+ *          since only odd numbers have inverses modulo 2^32. divide() picks
+ *          the cheaper method for the sizes it is given: classical long
+ *          division for short quotients or divisors, and above a tunable
+ *          threshold the reversed quotient as a power series, found by
+ *          Newton iteration on top of the short products in polymul.h.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "polydiv.h"
+#include "polymul.h"
+#include "polysimd.h"
+#include "scratch.h"
+
+// quotient or divisor size below which long division, a vector kernel call
+// per quotient coefficient, beats Newton iteration
+static int divideThreshold = 16384;
+
+/**----------------------------------------------------------------------------
+ * Finds the inverse of an odd number modulo 2^32 by Newton iteration: any
+ * odd a is its own inverse modulo 8, and each step x = x(2 - ax) doubles the
+ * number of correct low bits.
+ * @param a  The number to invert.
+ * @pre a is odd.
+ * @post None.
+ * @return The x for which a * x is 1 modulo 2^32.
+ */
+static unsigned int invertOdd(unsigned int a)
+{
+    unsigned int x = a;
+
+    // 3, 6, 12, 24, then 48 correct bits
+    for (int i = 0; i < 4; ++i)
+    {
+        x *= 2 - a * x;
+    } // end for (int i = 0)
+
+    return x;
+} // end invertOdd(unsigned int)
+
+/**----------------------------------------------------------------------------
+ * Computes the lowest coefficients of a product, including those above its
+ * largest power, which are 0.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0. out has room for len elements and
+ *      does not overlap a or b.
+ * @post out holds the coefficients of x^0 through x^(len - 1) of the
+ *       product.
+ */
+static void lowProduct(const int *a, int n, const int *b, int m, int len,
+                       int *out)
+{
+    int count = static_cast<long long>(n) + m - 1 < len ? n + m - 1 : len;
+
+    mulLow(a, n, b, m, count, out);
+
+    for (int i = count; i < len; ++i)
+    {
+        out[i] = 0;
+    } // end for (int i = count)
+} // end lowProduct(const int*, int, const int*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Divides one coefficient array by another, choosing the method by operand
+ * size.
+ * @param a  The coefficients of the dividend.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the divisor.
+ * @param m  The number of elements in b.
+ * @param quot  The array to receive the quotient.
+ * @param rem  The array to receive the remainder.
+ * @pre n is no less than m, which is greater than 0. b[m - 1] is odd. quot
+ *      has room for n - m + 1 elements and rem for m - 1; neither overlaps
+ *      the other, a or b.
+ * @post quot and rem hold the quotient and remainder, so that a is quot * b
+ *       + rem. a and b remain unchanged.
+ */
+void divide(const int *a, int n, const int *b, int m, int *quot, int *rem)
+{
+    if (n - m + 1 < divideThreshold || m < divideThreshold)
+    {
+        divClassical(a, n, b, m, quot, rem);
+    }
+    else
+    {
+        divNewton(a, n, b, m, quot, rem);
+    } // end if (n - m + 1 < divideThreshold || m < divideThreshold)
+} // end divide(const int*, int, const int*, int, int*, int*)
+
+/**----------------------------------------------------------------------------
+ * Divides one coefficient array by another with classical long division:
+ * each coefficient of the quotient, from the top, cancels the leading
+ * coefficient of what is left of the dividend, and a multiple of the
+ * divisor is subtracted with scaleAddCoeffs().
+ * @param a  The coefficients of the dividend.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the divisor.
+ * @param m  The number of elements in b.
+ * @param quot  The array to receive the quotient.
+ * @param rem  The array to receive the remainder.
+ * @pre n is no less than m, which is greater than 0. b[m - 1] is odd. quot
+ *      has room for n - m + 1 elements and rem for m - 1; neither overlaps
+ *      the other, a or b.
+ * @post quot and rem hold the quotient and remainder.
+ */
+void divClassical(const int *a, int n, const int *b, int m, int *quot,
+                  int *rem)
+{
+    unsigned int inverse = invertOdd(static_cast<unsigned int>(b[m - 1]));
+    ScratchBuffer buffer(n);
+    int *left = reinterpret_cast<int*>(buffer.data());
+
+    for (int i = 0; i < n; ++i)
+    {
+        left[i] = a[i];
+    } // end for (int i = 0)
+
+    for (int i = n - m; i >= 0; --i)
+    {
+        unsigned int coeff = static_cast<unsigned int>(left[i + m - 1])
+                             * inverse;
+
+        // the leading element cancels by construction; skip it
+        quot[i] = static_cast<int>(coeff);
+        scaleAddCoeffs(left + i, b, static_cast<int>(0u - coeff), m - 1);
+    } // end for (int i = n - m)
+
+    for (int i = 0; i < m - 1; ++i)
+    {
+        rem[i] = left[i];
+    } // end for (int i = 0)
+} // end divClassical(const int*, int, const int*, int, int*, int*)
+
+/**----------------------------------------------------------------------------
+ * Divides one coefficient array by another with Newton iteration. The
+ * quotient is found from the top in blocks of at most m coefficients. For
+ * each block, the reversed block is the reversed top of what is left of the
+ * dividend times the inverse of the reversed divisor, modulo the block's
+ * length; the block times the divisor is then subtracted, which needs only
+ * its m - 1 lowest coefficients since the rest cancel. The inverse is found
+ * once and serves every block, so a long quotient costs a few products of
+ * the divisor's size per block rather than products of its own size.
+ * @param a  The coefficients of the dividend.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the divisor.
+ * @param m  The number of elements in b.
+ * @param quot  The array to receive the quotient.
+ * @param rem  The array to receive the remainder.
+ * @pre n is no less than m, which is greater than 0. b[m - 1] is odd. quot
+ *      has room for n - m + 1 elements and rem for m - 1; neither overlaps
+ *      the other, a or b.
+ * @post quot and rem hold the quotient and remainder.
+ */
+void divNewton(const int *a, int n, const int *b, int m, int *quot, int *rem)
+{
+    int k = n - m + 1;
+    int width = m < k ? m : k;
+    ScratchBuffer buffer(n + 4 * width + m - 1);
+    int *left = reinterpret_cast<int*>(buffer.data());
+    int *revB = left + n;
+    int *inverse = revB + width;
+    int *revTop = inverse + width;
+    int *revQuot = revTop + width;
+    int *low = revQuot + width;
+
+    for (int i = 0; i < n; ++i)
+    {
+        left[i] = a[i];
+    } // end for (int i = 0)
+
+    for (int i = 0; i < width; ++i)
+    {
+        revB[i] = b[m - 1 - i];
+    } // end for (int i = 0)
+
+    invertSeries(revB, width, width, inverse);
+
+    // left matters below x^top; each block clears its top count powers
+    for (int top = n, count; top >= m; top -= count)
+    {
+        count = top - m + 1 < width ? top - m + 1 : width;
+
+        int start = top - m + 1 - count;
+
+        for (int i = 0; i < count; ++i)
+        {
+            revTop[i] = left[top - 1 - i];
+        } // end for (int i = 0)
+
+        lowProduct(revTop, count, inverse, count, count, revQuot);
+
+        for (int i = 0; i < count; ++i)
+        {
+            quot[start + count - 1 - i] = revQuot[i];
+        } // end for (int i = 0)
+
+        if (m > 1)
+        {
+            lowProduct(quot + start, count, b, m - 1, m - 1, low);
+            subCoeffs(left + start, low, m - 1);
+        } // end if (m > 1)
+    } // end for (int top = n, count)
+
+    for (int i = 0; i < m - 1; ++i)
+    {
+        rem[i] = left[i];
+    } // end for (int i = 0)
+} // end divNewton(const int*, int, const int*, int, int*, int*)
+
+/**----------------------------------------------------------------------------
+ * Computes the inverse of a power series: the g for which f * g is 1 modulo
+ * x^len. With g correct below x^cur, fg is 1 plus an error that starts at
+ * x^cur; g - g(fg - 1) is then correct below x^2cur, and differs from g only
+ * from x^cur up, by minus g times the error.
+ * @param f  The coefficients of the series.
+ * @param n  The number of elements in f.
+ * @param len  The number of coefficients of the inverse to compute.
+ * @param out  The array to receive the inverse.
+ * @pre n and len are greater than 0 and f[0] is odd. out has room for len
+ *      elements and does not overlap f.
+ * @post out holds the len lowest coefficients of the inverse of f.
+ */
+void invertSeries(const int *f, int n, int len, int *out)
+{
+    out[0] = static_cast<int>(invertOdd(static_cast<unsigned int>(f[0])));
+
+    if (len < 2)
+    {
+        return;
+    } // end if (len < 2)
+
+    ScratchBuffer buffer(2 * len);
+    int *error = reinterpret_cast<int*>(buffer.data());
+    int *fix = error + len;
+
+    for (int cur = 1, next; cur < len; cur = next)
+    {
+        next = len - cur > cur ? 2 * cur : len;
+
+        lowProduct(f, n < next ? n : next, out, cur, next, error);
+        lowProduct(out, cur, error + cur, next - cur, next - cur, fix);
+
+        for (int i = cur; i < next; ++i)
+        {
+            out[i] = static_cast<int>(0u - static_cast<unsigned int>(
+                                                fix[i - cur]));
+        } // end for (int i = cur)
+    } // end for (int cur = 1, next)
+} // end invertSeries(const int*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Mutator for the size at which divide() switches from long division to
+ * Newton iteration. Long division is used when either the quotient or the
+ * divisor has fewer elements than this, since its cost is their product.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to divide() use the new threshold.
+ */
+void setDivideThreshold(int threshold)
+{
+    if (threshold < 1)
+    {
+        threshold = 1;
+    } // end if (threshold < 1)
+
+    divideThreshold = threshold;
+} // end setDivideThreshold(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the divide threshold.
+ * @pre None.
+ * @post None.
+ * @return The size at which Newton iteration replaces long division.
+ */
+int getDivideThreshold()
+{
+    return divideThreshold;
+} // end getDivideThreshold()
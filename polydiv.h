@@ -0,0 +1,109 @@
+/**
+ * @file    polydiv.h
+ * @brief   Division kernels for the coefficient arrays behind Poly. Each
+ *          kernel takes arrays of ints, where the index of an element is its
+ *          power, and arithmetic wraps around modulo 2^32 as it does
+ *          everywhere else in Poly. In that ring, a polynomial can be divided
+ *          by another exactly when the divisor's leading coefficient is odd,
+ *          since only odd numbers have inverses modulo 2^32. divide() picks
+ *          the cheaper method for the sizes it is given: classical long
+ *          division for short quotients or divisors, and above a tunable
+ *          threshold the reversed quotient as a power series, found by
+ *          Newton iteration on top of the short products in polymul.h.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYDIV_H
+#define	_POLYDIV_H
+
+/**----------------------------------------------------------------------------
+ * Divides one coefficient array by another, choosing the method by operand
+ * size.
+ * @param a  The coefficients of the dividend.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the divisor.
+ * @param m  The number of elements in b.
+ * @param quot  The array to receive the quotient.
+ * @param rem  The array to receive the remainder.
+ * @pre n is no less than m, which is greater than 0. b[m - 1] is odd. quot
+ *      has room for n - m + 1 elements and rem for m - 1; neither overlaps
+ *      the other, a or b.
+ * @post quot and rem hold the quotient and remainder, so that a is quot * b
+ *       + rem. a and b remain unchanged.
+ */
+void divide(const int *a, int n, const int *b, int m, int *quot, int *rem);
+
+/**----------------------------------------------------------------------------
+ * Divides one coefficient array by another with classical long division:
+ * each coefficient of the quotient, from the top, cancels the leading
+ * coefficient of what is left of the dividend, and a multiple of the
+ * divisor is subtracted with scaleAddCoeffs().
+ * @param a  The coefficients of the dividend.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the divisor.
+ * @param m  The number of elements in b.
+ * @param quot  The array to receive the quotient.
+ * @param rem  The array to receive the remainder.
+ * @pre n is no less than m, which is greater than 0. b[m - 1] is odd. quot
+ *      has room for n - m + 1 elements and rem for m - 1; neither overlaps
+ *      the other, a or b.
+ * @post quot and rem hold the quotient and remainder.
+ */
+void divClassical(const int *a, int n, const int *b, int m, int *quot,
+                  int *rem);
+
+/**----------------------------------------------------------------------------
+ * Divides one coefficient array by another with Newton iteration. Reversing
+ * the order of the coefficients turns the quotient into the lowest
+ * coefficients of the reversed dividend times the inverse of the reversed
+ * divisor as a power series; that inverse is found by invertSeries(). The
+ * remainder needs only the lowest coefficients of quotient times divisor.
+ * All products are short products, so the whole division costs a small
+ * multiple of one multiplication.
+ * @param a  The coefficients of the dividend.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the divisor.
+ * @param m  The number of elements in b.
+ * @param quot  The array to receive the quotient.
+ * @param rem  The array to receive the remainder.
+ * @pre n is no less than m, which is greater than 0. b[m - 1] is odd. quot
+ *      has room for n - m + 1 elements and rem for m - 1; neither overlaps
+ *      the other, a or b.
+ * @post quot and rem hold the quotient and remainder.
+ */
+void divNewton(const int *a, int n, const int *b, int m, int *quot, int *rem);
+
+/**----------------------------------------------------------------------------
+ * Computes the inverse of a power series: the g for which f * g is 1 modulo
+ * x^len. Each Newton step g = g - g(fg - 1) doubles the number of correct
+ * coefficients, starting from the inverse of f[0] modulo 2^32.
+ * @param f  The coefficients of the series.
+ * @param n  The number of elements in f.
+ * @param len  The number of coefficients of the inverse to compute.
+ * @param out  The array to receive the inverse.
+ * @pre n and len are greater than 0 and f[0] is odd. out has room for len
+ *      elements and does not overlap f.
+ * @post out holds the len lowest coefficients of the inverse of f.
+ */
+void invertSeries(const int *f, int n, int len, int *out);
+
+/**----------------------------------------------------------------------------
+ * Mutator for the size at which divide() switches from long division to
+ * Newton iteration. Long division is used when either the quotient or the
+ * divisor has fewer elements than this, since its cost is their product.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to divide() use the new threshold.
+ */
+void setDivideThreshold(int threshold);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the divide threshold.
+ * @pre None.
+ * @post None.
+ * @return The size at which Newton iteration replaces long division.
+ */
+int getDivideThreshold();
+
+#endif	/* _POLYDIV_H */
@@ -0,0 +1,280 @@
+/**
+ * @file    polyeval.cpp
+ * @brief   Multipoint evaluation for the coefficient arrays behind Poly. Each
+ *          function takes arrays of ints, where the index of an element is
+ *          its power, and arithmetic wraps around modulo 2^32 as it does
+ *          everywhere else in Poly. evaluatePoints() picks the cheaper method
+ *          for the sizes it is given: Horner's rule run over a vector of
+ *          points at once for few points or short arrays, and above a
+ *          tunable threshold a subproduct tree, which reduces the array
+ *          modulo the products of ever smaller groups of (x - point) until
+ *          each remainder is short enough for Horner's rule.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "polyeval.h"
+#include "polydiv.h"
+#include "polymul.h"
+#include "polysimd.h"
+#include "scratch.h"
+
+// points per leaf of the subproduct tree; a leaf's remainder is evaluated
+// with Horner's rule, which beats dividing it further at this size
+static const int TREE_LEAF = 64;
+
+// number of points and of coefficients from which the subproduct tree beats
+// Horner's rule; below it, the tree's long divisions do as much work as
+// Horner's rule and only the Newton divisions near the root pull ahead
+static int evalTreeThreshold = 98304;
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at several points, choosing the method by
+ * the number of points and coefficients.
+ * @param coeffs  The coefficients, where the index of an element is its
+ *                power.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements.
+ * @post out[j] holds the value at points[j], wrapped around to 32 bits, for
+ *       each j below count. coeffs and points remain unchanged.
+ */
+void evaluatePoints(const int *coeffs, int n, const int *points, int count,
+                    int *out)
+{
+    if (count < evalTreeThreshold || n < evalTreeThreshold)
+    {
+        hornerCoeffs(coeffs, n, points, count, out);
+    }
+    else
+    {
+        evalTree(coeffs, n, points, count, out);
+    } // end if (count < evalTreeThreshold || n < evalTreeThreshold)
+} // end evaluatePoints(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Builds the product of (x - point) over a block of points, one linear
+ * factor at a time.
+ * @param points  The points of the block.
+ * @param count  The number of points.
+ * @param out  The array to receive the product.
+ * @pre count is greater than 0. out has room for count + 1 elements.
+ * @post out holds the count + 1 coefficients of the product, which is monic.
+ */
+static void buildLeaf(const int *points, int count, int *out)
+{
+    unsigned int *c = reinterpret_cast<unsigned int*>(out);
+
+    c[0] = 1;
+
+    for (int k = 0; k < count; ++k)
+    {
+        unsigned int p = static_cast<unsigned int>(points[k]);
+
+        // multiply c[0..k] by (x - p) from the top down
+        c[k + 1] = c[k];
+
+        for (int i = k; i > 0; --i)
+        {
+            c[i] = c[i - 1] - p * c[i];
+        } // end for (int i = k)
+
+        c[0] = 0u - p * c[0];
+    } // end for (int k = 0)
+} // end buildLeaf(const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Reduces a remainder modulo the nodes below one node of the subproduct
+ * tree and evaluates what reaches each leaf. Node t of level j covers the
+ * points from t * (TREE_LEAF << j) on and starts t * ((TREE_LEAF << j) + 1)
+ * elements into that level's array, so a node of k points has k + 1
+ * coefficients. A remainder already shorter than a child's product passes
+ * down to that child unchanged.
+ * @param levels  The arrays of the levels of the tree, leaves first.
+ * @param level  The level of the node.
+ * @param node  The index of the node within its level.
+ * @param rem  The coefficients of the remainder of the array modulo the
+ *             node's product.
+ * @param len  The number of elements in rem.
+ * @param points  All of the points.
+ * @param count  The number of points.
+ * @param out  The array to receive the values of all of the points.
+ * @pre len is greater than 0 and no more than the node's number of points.
+ * @post out holds the values at the node's points.
+ */
+static void descend(int *const *levels, int level, int node, const int *rem,
+                    int len, const int *points, int count, int *out)
+{
+    int span = TREE_LEAF << level;
+    int first = node * span;
+
+    if (level == 0)
+    {
+        int last = first + span < count ? first + span : count;
+
+        hornerCoeffs(rem, len, points + first, last - first, out + first);
+        return;
+    } // end if (level == 0)
+
+    int half = span / 2;
+
+    for (int child = 2 * node; child <= 2 * node + 1; ++child)
+    {
+        int start = child * half;
+
+        if (start >= count)
+        {
+            break;
+        } // end if (start >= count)
+
+        int size = (start + half < count ? half : count - start) + 1;
+        const int *product = levels[level - 1] + child * (half + 1);
+
+        if (len < size)
+        {
+            descend(levels, level - 1, child, rem, len, points, count, out);
+            continue;
+        } // end if (len < size)
+
+        ScratchBuffer buffer(len);
+        int *quot = reinterpret_cast<int*>(buffer.data());
+        int *low = quot + len - size + 1;
+
+        divide(rem, len, product, size, quot, low);
+        descend(levels, level - 1, child, low, size - 1, points, count, out);
+    } // end for (int child = 2 * node)
+} // end descend(int* const*, int, int, const int*, int, ...)
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at several points with a subproduct tree.
+ * The points are split into blocks; the product of (x - point) over each
+ * block is a leaf, and each node above is the product of its two children,
+ * built with multiply(). The value of the array at a point is its remainder
+ * modulo (x - point), so remainders are taken with divide() from the root
+ * down, each node reducing its parent's; every divisor is monic and so
+ * always divisible. A leaf's remainder is shorter than its block and is
+ * evaluated there with Horner's rule. Building and descending the tree each
+ * cost about log2(count) products or divisions of count coefficients.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n and count are greater than 0. points and out have at least count
+ *      elements.
+ * @post out[j] holds the value at points[j], wrapped around to 32 bits, for
+ *       each j below count.
+ */
+void evalTree(const int *coeffs, int n, const int *points, int count,
+              int *out)
+{
+    int height = 1;
+
+    while ((TREE_LEAF << (height - 1)) < count)
+    {
+        ++height;
+    } // end while ((TREE_LEAF << (height - 1)) < count)
+
+    // level j holds count coefficients plus one per node
+    int total = 0;
+
+    for (int j = 0; j < height; ++j)
+    {
+        int span = TREE_LEAF << j;
+
+        total += count + (count + span - 1) / span;
+    } // end for (int j = 0)
+
+    ScratchBuffer tree(total);
+    int *storage = reinterpret_cast<int*>(tree.data());
+    int *levels[32];
+
+    for (int j = 0, offset = 0; j < height; ++j)
+    {
+        int span = TREE_LEAF << j;
+
+        levels[j] = storage + offset;
+        offset += count + (count + span - 1) / span;
+    } // end for (int j = 0, offset = 0)
+
+    for (int first = 0; first < count; first += TREE_LEAF)
+    {
+        int size = first + TREE_LEAF < count ? TREE_LEAF : count - first;
+
+        buildLeaf(points + first, size, levels[0] + first + first / TREE_LEAF);
+    } // end for (int first = 0)
+
+    for (int j = 1; j < height; ++j)
+    {
+        int half = TREE_LEAF << (j - 1);
+
+        for (int node = 0; node * 2 * half < count; ++node)
+        {
+            int start = node * 2 * half;
+            int *left = levels[j - 1] + 2 * node * (half + 1);
+            int *target = levels[j] + node * (2 * half + 1);
+
+            if (start + half >= count)
+            {
+                // a lone child passes up unchanged
+                for (int i = 0; i <= count - start; ++i)
+                {
+                    target[i] = left[i];
+                } // end for (int i = 0)
+
+                continue;
+            } // end if (start + half >= count)
+
+            int right = (start + 2 * half < count ? half : count - start
+                         - half) + 1;
+
+            multiply(left, half + 1, left + half + 1, right, target);
+        } // end for (int node = 0)
+    } // end for (int j = 1)
+
+    if (n <= count)
+    {
+        descend(levels, height - 1, 0, coeffs, n, points, count, out);
+        return;
+    } // end if (n <= count)
+
+    ScratchBuffer buffer(n);
+    int *quot = reinterpret_cast<int*>(buffer.data());
+    int *low = quot + n - count;
+
+    divide(coeffs, n, levels[height - 1], count + 1, quot, low);
+    descend(levels, height - 1, 0, low, count, points, count, out);
+} // end evalTree(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Mutator for the size at which evaluatePoints() switches from Horner's rule
+ * to the subproduct tree. The tree is used when both the number of points
+ * and the number of coefficients reach it, since Horner's rule costs their
+ * product while the tree saves work only once its divisions are long enough
+ * for divide() to use Newton iteration.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to evaluatePoints() use the new threshold.
+ */
+void setEvalTreeThreshold(int threshold)
+{
+    if (threshold < 1)
+    {
+        threshold = 1;
+    } // end if (threshold < 1)
+
+    evalTreeThreshold = threshold;
+} // end setEvalTreeThreshold(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the evaluation tree threshold.
+ * @pre None.
+ * @post None.
+ * @return The size at which the subproduct tree replaces Horner's rule.
+ */
+int getEvalTreeThreshold()
+{
+    return evalTreeThreshold;
+} // end getEvalTreeThreshold()
@@ -0,0 +1,78 @@
+/**
+ * @file    polyeval.h
+ * @brief   Multipoint evaluation for the coefficient arrays behind Poly. Each
+ *          function takes arrays of ints, where the index of an element is
+ *          its power, and arithmetic wraps around modulo 2^32 as it does
+ *          everywhere else in Poly. evaluatePoints() picks the cheaper method
+ *          for the sizes it is given: Horner's rule run over a vector of
+ *          points at once for few points or short arrays, and above a
+ *          tunable threshold a subproduct tree, which reduces the array
+ *          modulo the products of ever smaller groups of (x - point) until
+ *          each remainder is short enough for Horner's rule.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYEVAL_H
+#define	_POLYEVAL_H
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at several points, choosing the method by
+ * the number of points and coefficients.
+ * @param coeffs  The coefficients, where the index of an element is its
+ *                power.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements.
+ * @post out[j] holds the value at points[j], wrapped around to 32 bits, for
+ *       each j below count. coeffs and points remain unchanged.
+ */
+void evaluatePoints(const int *coeffs, int n, const int *points, int count,
+                    int *out);
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at several points with a subproduct tree.
+ * The points are split into blocks; the product of (x - point) over each
+ * block is a leaf, and each node above is the product of its two children,
+ * built with multiply(). The value of the array at a point is its remainder
+ * modulo (x - point), so remainders are taken with divide() from the root
+ * down, each node reducing its parent's; every divisor is monic and so
+ * always divisible. A leaf's remainder is shorter than its block and is
+ * evaluated there with Horner's rule. Building and descending the tree each
+ * cost about log2(count) products or divisions of count coefficients.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n and count are greater than 0. points and out have at least count
+ *      elements.
+ * @post out[j] holds the value at points[j], wrapped around to 32 bits, for
+ *       each j below count.
+ */
+void evalTree(const int *coeffs, int n, const int *points, int count,
+              int *out);
+
+/**----------------------------------------------------------------------------
+ * Mutator for the size at which evaluatePoints() switches from Horner's rule
+ * to the subproduct tree. The tree is used when both the number of points
+ * and the number of coefficients reach it, since Horner's rule costs their
+ * product while the tree saves work only once its divisions are long enough
+ * for divide() to use Newton iteration.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to evaluatePoints() use the new threshold.
+ */
+void setEvalTreeThreshold(int threshold);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the evaluation tree threshold.
+ * @pre None.
+ * @post None.
+ * @return The size at which the subproduct tree replaces Horner's rule.
+ */
+int getEvalTreeThreshold();
+
+#endif	/* _POLYEVAL_H */
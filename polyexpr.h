@@ -0,0 +1,341 @@
+/**
+ * @file    polyexpr.h
+ * @brief   Expression templates behind the arithmetic operators of Poly. An
+ *          expression such as A + B - 15 does not compute anything when it
+ *          is written; it builds a small tree of nodes that refer to their
+ *          operands. The tree is evaluated when it is assigned to a Poly (or
+ *          used to construct one), in a single pass over the powers of the
+ *          result that writes each coefficient straight into the
+ *          destination, so sums, differences and scalar products of any
+ *          length allocate nothing along the way. Products of two
+ *          polynomials are not elementwise, so each of them is computed into
+ *          a Poly of its own as soon as it is written and enters the tree as
+ *          an operand. If any operand is sparse, the tree is instead
+ *          evaluated one operand at a time with the ordinary Poly operators.
+ *
+ *          Each node type E derives from PolyExpr<E> and provides:
+ *              length()  an upper bound on the number of coefficients;
+ *              coeff(i)  the coefficient of x^i, for any i >= 0;
+ *              hasSparse()  true if any operand below it is sparse;
+ *              addTo(dest, subtract, scale)  adds or subtracts scale times
+ *                  the expression to dest, with the Poly operators.
+ *          Arithmetic wraps around on overflow, as everywhere else in Poly.
+ *
+ *          A node refers to its Poly operands rather than copying them, so
+ *          an expression must be used before the end of the statement that
+ *          wrote it, as it is in D = A * B - 15.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYEXPR_H
+#define	_POLYEXPR_H
+
+class Poly;
+
+/**----------------------------------------------------------------------------
+ * Base of every expression node, and of Poly itself, which is the leaf of
+ * every expression. Lets the operators accept any expression while keeping
+ * its exact type.
+ */
+template <class E>
+class PolyExpr
+{
+public:
+
+    /**------------------------------------------------------------------------
+     * Accessor for the node as its own type.
+     * @pre None.
+     * @post None.
+     * @return A reference to this node as an E.
+     */
+    const E& self() const
+    {
+        return static_cast<const E&>(*this);
+    } // end self()
+};
+
+/**----------------------------------------------------------------------------
+ * How a node holds an operand of type E: nodes are small and are copied,
+ * while a Poly is referred to.
+ */
+template <class E>
+struct PolyOperand
+{
+    typedef const E type;
+};
+
+template <>
+struct PolyOperand<Poly>
+{
+    typedef const Poly& type;
+};
+
+/**----------------------------------------------------------------------------
+ * An integer constant mixed into an expression, as in A - 15. Stands for the
+ * polynomial with that value in its x^0 coefficient.
+ */
+class PolyConstant : public PolyExpr<PolyConstant>
+{
+public:
+
+    /**------------------------------------------------------------------------
+     * Constructor. Creates a node for a constant.
+     * @param value  The value of the x^0 coefficient.
+     * @pre None.
+     * @post The node represents value.
+     */
+    explicit PolyConstant(int value) : value(value)
+    {
+    } // end PolyConstant(int)
+
+    int length() const
+    {
+        return value != 0;
+    } // end length()
+
+    int coeff(int i) const
+    {
+        return i == 0 ? value : 0;
+    } // end coeff(int)
+
+    bool hasSparse() const
+    {
+        return false;
+    } // end hasSparse()
+
+    // defined in poly.cpp, where Poly is complete
+    void addTo(Poly& dest, bool subtract, int scale) const;
+
+private:
+
+    int value;
+};
+
+/**----------------------------------------------------------------------------
+ * The sum of two expressions.
+ */
+template <class L, class R>
+class PolySum : public PolyExpr<PolySum<L, R> >
+{
+public:
+
+    /**------------------------------------------------------------------------
+     * Constructor. Creates a node for lhs + rhs.
+     * @param lhs  The first addend.
+     * @param rhs  The second addend.
+     * @pre lhs and rhs outlive this node.
+     * @post The node represents lhs + rhs.
+     */
+    PolySum(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs)
+    {
+    } // end PolySum(const L&, const R&)
+
+    int length() const
+    {
+        int left = lhs.length(), right = rhs.length();
+
+        return left > right ? left : right;
+    } // end length()
+
+    int coeff(int i) const
+    {
+        return static_cast<int>(static_cast<unsigned int>(lhs.coeff(i))
+                                + static_cast<unsigned int>(rhs.coeff(i)));
+    } // end coeff(int)
+
+    bool hasSparse() const
+    {
+        return lhs.hasSparse() || rhs.hasSparse();
+    } // end hasSparse()
+
+    template <class P>
+    void addTo(P& dest, bool subtract, int scale) const
+    {
+        lhs.addTo(dest, subtract, scale);
+        rhs.addTo(dest, subtract, scale);
+    } // end addTo(P&, bool, int)
+
+private:
+
+    typename PolyOperand<L>::type lhs;
+    typename PolyOperand<R>::type rhs;
+};
+
+/**----------------------------------------------------------------------------
+ * The difference of two expressions.
+ */
+template <class L, class R>
+class PolyDifference : public PolyExpr<PolyDifference<L, R> >
+{
+public:
+
+    /**------------------------------------------------------------------------
+     * Constructor. Creates a node for lhs - rhs.
+     * @param lhs  The minuend.
+     * @param rhs  The subtrahend.
+     * @pre lhs and rhs outlive this node.
+     * @post The node represents lhs - rhs.
+     */
+    PolyDifference(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs)
+    {
+    } // end PolyDifference(const L&, const R&)
+
+    int length() const
+    {
+        int left = lhs.length(), right = rhs.length();
+
+        return left > right ? left : right;
+    } // end length()
+
+    int coeff(int i) const
+    {
+        return static_cast<int>(static_cast<unsigned int>(lhs.coeff(i))
+                                - static_cast<unsigned int>(rhs.coeff(i)));
+    } // end coeff(int)
+
+    bool hasSparse() const
+    {
+        return lhs.hasSparse() || rhs.hasSparse();
+    } // end hasSparse()
+
+    template <class P>
+    void addTo(P& dest, bool subtract, int scale) const
+    {
+        lhs.addTo(dest, subtract, scale);
+        rhs.addTo(dest, !subtract, scale);
+    } // end addTo(P&, bool, int)
+
+private:
+
+    typename PolyOperand<L>::type lhs;
+    typename PolyOperand<R>::type rhs;
+};
+
+/**----------------------------------------------------------------------------
+ * An expression multiplied by an integer, as in A * 3.
+ */
+template <class E>
+class PolyScaled : public PolyExpr<PolyScaled<E> >
+{
+public:
+
+    /**------------------------------------------------------------------------
+     * Constructor. Creates a node for operand * factor.
+     * @param operand  The expression to scale.
+     * @param factor  The integer to scale it by.
+     * @pre operand outlives this node.
+     * @post The node represents operand * factor.
+     */
+    PolyScaled(const E& operand, int factor)
+        : operand(operand), factor(factor)
+    {
+    } // end PolyScaled(const E&, int)
+
+    int length() const
+    {
+        return operand.length();
+    } // end length()
+
+    int coeff(int i) const
+    {
+        return static_cast<int>(static_cast<unsigned int>(operand.coeff(i))
+                                * static_cast<unsigned int>(factor));
+    } // end coeff(int)
+
+    bool hasSparse() const
+    {
+        return operand.hasSparse();
+    } // end hasSparse()
+
+    template <class P>
+    void addTo(P& dest, bool subtract, int scale) const
+    {
+        operand.addTo(dest, subtract, static_cast<int>(
+                static_cast<unsigned int>(scale)
+                * static_cast<unsigned int>(factor)));
+    } // end addTo(P&, bool, int)
+
+private:
+
+    typename PolyOperand<E>::type operand;
+    int factor;
+};
+
+/**----------------------------------------------------------------------------
+ * Overloaded + operator. Builds the sum of two expressions.
+ * @param lhs  The first addend.
+ * @param rhs  The second addend.
+ * @pre None.
+ * @post lhs and rhs remain unchanged.
+ * @return An expression for lhs + rhs.
+ */
+template <class L, class R>
+inline PolySum<L, R> operator+(const PolyExpr<L>& lhs, const PolyExpr<R>& rhs)
+{
+    return PolySum<L, R>(lhs.self(), rhs.self());
+} // end operator+(const PolyExpr<L>&, const PolyExpr<R>&)
+
+template <class L>
+inline PolySum<L, PolyConstant> operator+(const PolyExpr<L>& lhs, int rhs)
+{
+    return PolySum<L, PolyConstant>(lhs.self(), PolyConstant(rhs));
+} // end operator+(const PolyExpr<L>&, int)
+
+template <class R>
+inline PolySum<PolyConstant, R> operator+(int lhs, const PolyExpr<R>& rhs)
+{
+    return PolySum<PolyConstant, R>(PolyConstant(lhs), rhs.self());
+} // end operator+(int, const PolyExpr<R>&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded - operator. Builds the difference of two expressions.
+ * @param lhs  The minuend.
+ * @param rhs  The subtrahend.
+ * @pre None.
+ * @post lhs and rhs remain unchanged.
+ * @return An expression for lhs - rhs.
+ */
+template <class L, class R>
+inline PolyDifference<L, R> operator-(const PolyExpr<L>& lhs,
+                                      const PolyExpr<R>& rhs)
+{
+    return PolyDifference<L, R>(lhs.self(), rhs.self());
+} // end operator-(const PolyExpr<L>&, const PolyExpr<R>&)
+
+template <class L>
+inline PolyDifference<L, PolyConstant> operator-(const PolyExpr<L>& lhs,
+                                                 int rhs)
+{
+    return PolyDifference<L, PolyConstant>(lhs.self(), PolyConstant(rhs));
+} // end operator-(const PolyExpr<L>&, int)
+
+template <class R>
+inline PolyDifference<PolyConstant, R> operator-(int lhs,
+                                                 const PolyExpr<R>& rhs)
+{
+    return PolyDifference<PolyConstant, R>(PolyConstant(lhs), rhs.self());
+} // end operator-(int, const PolyExpr<R>&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded * operator for an integer factor. Builds the expression scaled
+ * by that integer; multiplying two polynomials is declared in poly.h.
+ * @param lhs  The expression to scale.
+ * @param rhs  The integer to scale it by.
+ * @pre None.
+ * @post lhs remains unchanged.
+ * @return An expression for lhs * rhs.
+ */
+template <class L>
+inline PolyScaled<L> operator*(const PolyExpr<L>& lhs, int rhs)
+{
+    return PolyScaled<L>(lhs.self(), rhs);
+} // end operator*(const PolyExpr<L>&, int)
+
+template <class R>
+inline PolyScaled<R> operator*(int lhs, const PolyExpr<R>& rhs)
+{
+    return PolyScaled<R>(rhs.self(), lhs);
+} // end operator*(int, const PolyExpr<R>&)
+
+#endif	/* _POLYEXPR_H */
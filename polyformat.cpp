@@ -0,0 +1,108 @@
+/**
+ * @file    polyformat.cpp
+ * @brief   Text rendering for Poly and SparsePoly: the " +5x^7 -4x^3" form
+ *          that operator<< writes. Terms are rendered into a character
+ *          buffer with a hand-rolled integer formatter, two digits per
+ *          table lookup in the manner of std::to_chars, so that a whole
+ *          polynomial goes to its stream in one write instead of one
+ *          formatted insertion per sign, digit, x and ^.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "polyformat.h"
+
+// the two digits of each number from 00 to 99
+static const char DIGIT_PAIRS[] =
+        "000102030405060708091011121314151617181920212223242526272829"
+        "303132333435363738394041424344454647484950515253545556575859"
+        "606162636465666768697071727374757677787980818283848586878889"
+        "90919293949596979899";
+
+/**----------------------------------------------------------------------------
+ * Writes an integer in decimal, with a leading - if it is negative.
+ * @param out  The first character to write.
+ * @param value  The integer to write.
+ * @pre out has room for 11 characters.
+ * @post The integer is written from out on, without a terminating null.
+ * @return One past the last character written.
+ */
+char *formatInt(char *out, int value)
+{
+    unsigned int magnitude = static_cast<unsigned int>(value);
+
+    if (value < 0)
+    {
+        *out++ = '-';
+        magnitude = 0u - magnitude;
+    } // end if (value < 0)
+
+    int length = 1;
+
+    for (unsigned int bound = 10; length < 10 && magnitude >= bound;
+         bound *= 10)
+    {
+        ++length;
+    } // end for (unsigned int bound = 10; ...)
+
+    // fill from the last digit back, two at a time
+    char *end = out + length;
+    char *p = end;
+
+    while (magnitude >= 100)
+    {
+        unsigned int pair = magnitude % 100 * 2;
+
+        magnitude /= 100;
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+    } // end while (magnitude >= 100)
+
+    if (magnitude >= 10)
+    {
+        *--p = DIGIT_PAIRS[magnitude * 2 + 1];
+        *--p = DIGIT_PAIRS[magnitude * 2];
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + magnitude);
+    } // end if (magnitude >= 10)
+
+    return end;
+} // end formatInt(char*, int)
+
+/**----------------------------------------------------------------------------
+ * Writes one term as operator<< shows it: a space, the coefficient with a +
+ * if it is positive, then x for powers greater than 0 and ^ and the power
+ * for powers greater than 1.
+ * @param out  The first character to write.
+ * @param coeff  The coefficient.
+ * @param exp  The power.
+ * @pre out has room for TERM_TEXT_MAX characters. exp is not negative.
+ * @post The term is written from out on, without a terminating null.
+ * @return One past the last character written.
+ */
+char *formatTerm(char *out, int coeff, int exp)
+{
+    *out++ = ' ';
+
+    if (coeff > 0)
+    {
+        *out++ = '+';
+    } // end if (coeff > 0)
+
+    out = formatInt(out, coeff);
+
+    if (exp > 0)
+    {
+        *out++ = 'x';
+    } // end if (exp > 0)
+
+    if (exp > 1)
+    {
+        *out++ = '^';
+        out = formatInt(out, exp);
+    } // end if (exp > 1)
+
+    return out;
+} // end formatTerm(char*, int, int)
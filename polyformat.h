@@ -0,0 +1,43 @@
+/**
+ * @file    polyformat.h
+ * @brief   Text rendering for Poly and SparsePoly: the " +5x^7 -4x^3" form
+ *          that operator<< writes. Terms are rendered into a character
+ *          buffer with a hand-rolled integer formatter, two digits per
+ *          table lookup in the manner of std::to_chars, so that a whole
+ *          polynomial goes to its stream in one write instead of one
+ *          formatted insertion per sign, digit, x and ^.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYFORMAT_H
+#define	_POLYFORMAT_H
+
+// most characters formatTerm() writes: space, sign, 10 digits, x, ^ and 10
+// more digits
+const int TERM_TEXT_MAX = 24;
+
+/**----------------------------------------------------------------------------
+ * Writes an integer in decimal, with a leading - if it is negative.
+ * @param out  The first character to write.
+ * @param value  The integer to write.
+ * @pre out has room for 11 characters.
+ * @post The integer is written from out on, without a terminating null.
+ * @return One past the last character written.
+ */
+char *formatInt(char *out, int value);
+
+/**----------------------------------------------------------------------------
+ * Writes one term as operator<< shows it: a space, the coefficient with a +
+ * if it is positive, then x for powers greater than 0 and ^ and the power
+ * for powers greater than 1.
+ * @param out  The first character to write.
+ * @param coeff  The coefficient.
+ * @param exp  The power.
+ * @pre out has room for TERM_TEXT_MAX characters. exp is not negative.
+ * @post The term is written from out on, without a terminating null.
+ * @return One past the last character written.
+ */
+char *formatTerm(char *out, int coeff, int exp);
+
+#endif	/* _POLYFORMAT_H */
@@ -0,0 +1,107 @@
+/**
+ * @file    polymap.cpp
+ * @brief   Memory mapping of files for Poly, so that a coefficient list
+ *          written by Poly::serialize() can be used where it lies in the
+ *          page cache instead of being read into a new array. Regions are
+ *          mapped with MAP_PRIVATE, which leaves copying a page to the kernel
+ *          until something writes to it. Only POSIX systems map; elsewhere
+ *          mapRegion() always fails and callers read the file instead.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "polymap.h"
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define	POLYMAP_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef POLYMAP_POSIX
+/**----------------------------------------------------------------------------
+ * Finds how far into its page a position in a file or in memory lies; a
+ * mapping has to start on a page boundary.
+ * @param position  The position.
+ * @pre position is not negative.
+ * @post None.
+ * @return The distance from the start of the page holding position.
+ */
+static long long pageOffset(long long position)
+{
+    static const long long page = sysconf(_SC_PAGESIZE);
+
+    return position % page;
+} // end pageOffset(long long)
+#endif
+
+/**----------------------------------------------------------------------------
+ * Maps part of a file into memory, privately and copy-on-write.
+ * @param path  The name of the file.
+ * @param offset  The position in the file of the first byte to map.
+ * @param length  The number of bytes to map; greater than 0.
+ * @pre None.
+ * @post The bytes are readable and writable through the pointer returned
+ *       until unmapRegion() is called with it. Writes do not reach the file.
+ * @return The first byte mapped, or NULL if the file could not be opened,
+ *         does not hold that many bytes from offset or could not be mapped.
+ */
+char *mapRegion(const char *path, long long offset, long long length)
+{
+    char *begin = NULL;
+
+#ifdef POLYMAP_POSIX
+    int file = open(path, O_RDONLY);
+    struct stat status;
+
+    if (file < 0)
+    {
+        return NULL;
+    } // end if (file < 0)
+
+    // touching a mapped page past the end of the file would be fatal
+    if (offset >= 0 && length > 0 && fstat(file, &status) == 0
+        && status.st_size - offset >= length)
+    {
+        long long lead = pageOffset(offset);
+        void *base = mmap(NULL, static_cast<size_t>(lead + length),
+                          PROT_READ | PROT_WRITE, MAP_PRIVATE, file,
+                          static_cast<off_t>(offset - lead));
+
+        if (base != MAP_FAILED)
+        {
+            begin = static_cast<char*>(base) + lead;
+        } // end if (base != MAP_FAILED)
+    } // end if (offset >= 0 && length > 0 && ...)
+
+    close(file);
+#else
+    (void) path;
+    (void) offset;
+    (void) length;
+#endif
+
+    return begin;
+} // end mapRegion(const char*, long long, long long)
+
+/**----------------------------------------------------------------------------
+ * Releases a region mapped by mapRegion().
+ * @param begin  The pointer mapRegion() returned.
+ * @param length  The length given to mapRegion().
+ * @pre begin was mapped with length and has not been released.
+ * @post The region is no longer mapped.
+ */
+void unmapRegion(char *begin, long long length)
+{
+#ifdef POLYMAP_POSIX
+    long long lead = pageOffset(reinterpret_cast<size_t>(begin));
+
+    munmap(begin - lead, static_cast<size_t>(lead + length));
+#else
+    (void) begin;
+    (void) length;
+#endif
+} // end unmapRegion(char*, long long)
@@ -0,0 +1,39 @@
+/**
+ * @file    polymap.h
+ * @brief   Memory mapping of files for Poly, so that a coefficient list
+ *          written by Poly::serialize() can be used where it lies in the
+ *          page cache instead of being read into a new array. The mapping is
+ *          private: its pages are read from the file as they are touched,
+ *          and a page is copied the first time it is written, leaving the
+ *          file unchanged. Where memory mapping is not available, no region
+ *          can be mapped and callers read the file instead.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYMAP_H
+#define	_POLYMAP_H
+
+/**----------------------------------------------------------------------------
+ * Maps part of a file into memory, privately and copy-on-write.
+ * @param path  The name of the file.
+ * @param offset  The position in the file of the first byte to map.
+ * @param length  The number of bytes to map; greater than 0.
+ * @pre None.
+ * @post The bytes are readable and writable through the pointer returned
+ *       until unmapRegion() is called with it. Writes do not reach the file.
+ * @return The first byte mapped, or NULL if the file could not be opened,
+ *         does not hold that many bytes from offset or could not be mapped.
+ */
+char *mapRegion(const char *path, long long offset, long long length);
+
+/**----------------------------------------------------------------------------
+ * Releases a region mapped by mapRegion().
+ * @param begin  The pointer mapRegion() returned.
+ * @param length  The length given to mapRegion().
+ * @pre begin was mapped with length and has not been released.
+ * @post The region is no longer mapped.
+ */
+void unmapRegion(char *begin, long long length);
+
+#endif	/* _POLYMAP_H */
@@ -0,0 +1,1189 @@
+/**
+ * @file    polymul.cpp
+ * @brief   Multiplication kernels for the coefficient arrays behind Poly. Each
+ *          kernel takes two arrays of ints, where the index of an element is
+ *          its power, and writes their product into an output array that has
+ *          room for every power of the result. Arithmetic wraps around on
+ *          overflow exactly as the original int loop in Poly::operator* did.
+ *          multiply() picks the cheapest kernel for the sizes it is given:
+ *          the schoolbook double loop for small operands, Karatsuba
+ *          divide-and-conquer above a tunable threshold and the number-
+ *          theoretic transform in ntt.h above a second, larger one.
+ *          square() does the same for the product of an array with itself,
+ *          with kernels that compute each cross term once, and mulLow() for
+ *          the lowest coefficients of a product alone.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "polymul.h"
+#include "ntt.h"
+#include "polysimd.h"
+#include "scratch.h"
+#include "threadpool.h"
+#include <memory>
+
+// operand size below which the schoolbook loop beats Karatsuba
+static int karatsubaThreshold = 32;
+
+// operand size from which the number-theoretic transform beats Karatsuba
+static int nttThreshold = 8192;
+
+// product length from which multiply() splits the work across threads
+static int parallelThreshold = 32768;
+
+// threads a product may be split across; one per core unless changed
+static int threadCount = thread::hardware_concurrency() > 0
+                         ? static_cast<int>(thread::hardware_concurrency())
+                         : 1;
+
+// created when a product is first split; replaced when threadCount changes
+static unique_ptr<ThreadPool> pool;
+static mutex poolLock;
+
+// row length from which the schoolbook loops add whole rows with
+// scaleAddCoeffs()
+static const int ROW_MIN_LENGTH = 16;
+
+// share of a short product's length computed as a full product in
+// mulLowKaratsuba(), in tenths
+static const int SHORT_SPLIT = 7;
+
+// multiple of the Karatsuba threshold below which the schoolbook short
+// product, at half the work of the full loop, beats Mulders' split; long
+// long so that the multiple cannot overflow for a large threshold
+static const long long SHORT_SCHOOLBOOK = 8;
+
+// tile of the schoolbook product: output elements, and rows of the shorter
+// operand, worked on together; with the slice of the longer operand they
+// read, about 20 KB, which stays in a 32 KB L1 data cache
+static const int OUTPUT_BLOCK = 2048;
+static const int ROW_BLOCK = 256;
+
+/**----------------------------------------------------------------------------
+ * Schoolbook product of two unsigned arrays. Each element of the shorter
+ * operand adds a scaled row of the longer one into the output, through
+ * scaleAddCoeffs() and so with the widest vector instructions available,
+ * once rows reach ROW_MIN_LENGTH elements. The work is cut into tiles of
+ * ROW_BLOCK rows by OUTPUT_BLOCK output elements, and every row of a tile is
+ * added before moving on, so the output elements and the slice of the longer
+ * operand that a tile touches stay in L1 instead of being streamed from
+ * memory once per row.
+ * Unsigned arithmetic is used so that overflow wraps around with
+ * well-defined results.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the n + m - 1 coefficients of the product.
+ * @pre out does not overlap a or b.
+ * @post out holds the product of a and b.
+ */
+static void schoolbook(const unsigned int *a, int n, const unsigned int *b,
+                       int m, unsigned int *out)
+{
+    // let the rows run along the longer operand
+    if (n > m)
+    {
+        schoolbook(b, m, a, n, out);
+        return;
+    } // end if (n > m)
+
+    for (int k = 0; k < n + m - 1; ++k)
+    {
+        out[k] = 0;
+    } // end for (int k = 0)
+
+    // rows too short to fill a vector are cheaper without the call
+    if (m < ROW_MIN_LENGTH)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < m; ++j)
+            {
+                out[i + j] += a[i] * b[j];
+            } // end for (int j = 0)
+        } // end for (int i = 0)
+
+        return;
+    } // end if (m < ROW_MIN_LENGTH)
+
+    for (int first = 0; first < n; first += ROW_BLOCK)
+    {
+        int last = n - first < ROW_BLOCK ? n : first + ROW_BLOCK;
+
+        // these rows reach powers first through last + m - 2
+        for (int start = first; start < last + m - 1; start += OUTPUT_BLOCK)
+        {
+            int end = last + m - 1 - start < OUTPUT_BLOCK
+                      ? last + m - 1 : start + OUTPUT_BLOCK;
+
+            for (int i = first; i < last; ++i)
+            {
+                int lo = start - i > 0 ? start - i : 0;
+                int hi = end - i < m ? end - i : m;
+
+                if (lo < hi)
+                {
+                    scaleAddCoeffs(reinterpret_cast<int*>(out + i + lo),
+                                   reinterpret_cast<const int*>(b + lo),
+                                   static_cast<int>(a[i]), hi - lo);
+                } // end if (lo < hi)
+            } // end for (int i = first)
+        } // end for (int start = first)
+    } // end for (int first = 0)
+} // end schoolbook(const unsigned int*, int, ...)
+
+/**----------------------------------------------------------------------------
+ * Schoolbook square of an unsigned array. The cross terms a[i] * a[j] with
+ * i < j are added once, a row of the array above each element at a time,
+ * then the sums are doubled and the squares a[i] * a[i] added in. This takes
+ * n(n - 1)/2 + n multiplications instead of n^2.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the 2n - 1 coefficients of the square.
+ * @pre out does not overlap a.
+ * @post out holds the square of a.
+ */
+static void schoolbookSquare(const unsigned int *a, int n, unsigned int *out)
+{
+    for (int k = 0; k < 2 * n - 1; ++k)
+    {
+        out[k] = 0;
+    } // end for (int k = 0)
+
+    for (int i = 0; i < n - 1; ++i)
+    {
+        int len = n - 1 - i;
+
+        if (len >= ROW_MIN_LENGTH)
+        {
+            scaleAddCoeffs(reinterpret_cast<int*>(out + 2 * i + 1),
+                           reinterpret_cast<const int*>(a + i + 1),
+                           static_cast<int>(a[i]), len);
+        }
+        else
+        {
+            for (int j = 1; j <= len; ++j)
+            {
+                out[2 * i + j] += a[i] * a[i + j];
+            } // end for (int j = 1)
+        } // end if (len >= ROW_MIN_LENGTH)
+    } // end for (int i = 0)
+
+    for (int k = 0; k < 2 * n - 1; ++k)
+    {
+        out[k] <<= 1;
+    } // end for (int k = 0)
+
+    for (int i = 0; i < n; ++i)
+    {
+        out[2 * i] += a[i] * a[i];
+    } // end for (int i = 0)
+} // end schoolbookSquare(const unsigned int*, int, unsigned int*)
+
+/**----------------------------------------------------------------------------
+ * Schoolbook short product of two unsigned arrays: the len lowest
+ * coefficients only. Each element of the shorter operand adds the part of
+ * its row of the longer one that lands below x^len.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the len lowest coefficients.
+ * @pre len is no more than n + m - 1. out does not overlap a or b.
+ * @post out holds the low part of the product of a and b.
+ */
+static void schoolbookLow(const unsigned int *a, int n, const unsigned int *b,
+                          int m, int len, unsigned int *out)
+{
+    // let the rows run along the longer operand
+    if (n > m)
+    {
+        schoolbookLow(b, m, a, n, len, out);
+        return;
+    } // end if (n > m)
+
+    for (int k = 0; k < len; ++k)
+    {
+        out[k] = 0;
+    } // end for (int k = 0)
+
+    for (int i = 0; i < n && i < len; ++i)
+    {
+        int row = len - i < m ? len - i : m;
+
+        if (row >= ROW_MIN_LENGTH)
+        {
+            scaleAddCoeffs(reinterpret_cast<int*>(out + i),
+                           reinterpret_cast<const int*>(b),
+                           static_cast<int>(a[i]), row);
+        }
+        else
+        {
+            for (int j = 0; j < row; ++j)
+            {
+                out[i + j] += a[i] * b[j];
+            } // end for (int j = 0)
+        } // end if (row >= ROW_MIN_LENGTH)
+    } // end for (int i = 0)
+} // end schoolbookLow(const unsigned int*, int, ...)
+
+/**----------------------------------------------------------------------------
+ * Determines how much scratch space karatsuba() needs for operands of a given
+ * size, including all of its recursive calls.
+ * @param n  The number of elements in each operand.
+ * @pre None.
+ * @post None.
+ * @return The number of unsigned ints of scratch space required.
+ */
+static int karatsubaWorkSize(int n)
+{
+    int total = 0;
+
+    while (n >= karatsubaThreshold)
+    {
+        int hi = n - n / 2;
+
+        // two half-sums and their product
+        total += 4 * hi - 1;
+        n = hi;
+    } // end while (n >= karatsubaThreshold)
+
+    return total;
+} // end karatsubaWorkSize(int)
+
+/**----------------------------------------------------------------------------
+ * Karatsuba product of two unsigned arrays of equal size. Each operand is
+ * split into a low half of n / 2 elements and a high half of the rest, so
+ * that a = a0 + a1 x^lo. The product is then a0b0 + ((a0 + a1)(b0 + b1) -
+ * a0b0 - a1b1) x^lo + a1b1 x^2lo, which needs three half-size products
+ * instead of four.
+ * @param a  The coefficients of the first operand.
+ * @param b  The coefficients of the second operand.
+ * @param n  The number of elements in each of a and b.
+ * @param out  The array to receive the 2n - 1 coefficients of the product.
+ * @param work  Scratch space of at least karatsubaWorkSize(n) elements.
+ * @pre out and work do not overlap each other, a or b.
+ * @post out holds the product of a and b. work is overwritten.
+ */
+static void karatsuba(const unsigned int *a, const unsigned int *b, int n,
+                      unsigned int *out, unsigned int *work)
+{
+    if (n < karatsubaThreshold)
+    {
+        schoolbook(a, n, b, n, out);
+        return;
+    } // end if (n < karatsubaThreshold)
+
+    int lo = n / 2, hi = n - lo;
+    unsigned int *sumA = work;
+    unsigned int *sumB = work + hi;
+    unsigned int *mid = work + 2 * hi;
+    unsigned int *next = mid + 2 * hi - 1;
+
+    for (int i = 0; i < lo; ++i)
+    {
+        sumA[i] = a[i] + a[lo + i];
+        sumB[i] = b[i] + b[lo + i];
+    } // end for (int i = 0)
+
+    // the high half is one longer when n is odd
+    if (hi > lo)
+    {
+        sumA[lo] = a[n - 1];
+        sumB[lo] = b[n - 1];
+    } // end if (hi > lo)
+
+    // low and high products go straight into their final positions
+    karatsuba(a, b, lo, out, next);
+    out[2 * lo - 1] = 0;
+    karatsuba(a + lo, b + lo, hi, out + 2 * lo, next);
+    karatsuba(sumA, sumB, hi, mid, next);
+
+    for (int i = 0; i < 2 * lo - 1; ++i)
+    {
+        mid[i] -= out[i];
+    } // end for (int i = 0)
+
+    for (int i = 0; i < 2 * hi - 1; ++i)
+    {
+        mid[i] -= out[2 * lo + i];
+    } // end for (int i = 0)
+
+    for (int i = 0; i < 2 * hi - 1; ++i)
+    {
+        out[lo + i] += mid[i];
+    } // end for (int i = 0)
+} // end karatsuba(const unsigned int*, const unsigned int*, ...)
+
+/**----------------------------------------------------------------------------
+ * Karatsuba square of an unsigned array. With a = a0 + a1 x^lo, the square
+ * is a0^2 + ((a0 + a1)^2 - a0^2 - a1^2) x^lo + a1^2 x^2lo, so the three
+ * half-size products of karatsuba() become three half-size squares, and
+ * only one half-sum is needed.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the 2n - 1 coefficients of the square.
+ * @param work  Scratch space of at least karatsubaWorkSize(n) elements.
+ * @pre out and work do not overlap each other or a.
+ * @post out holds the square of a. work is overwritten.
+ */
+static void karatsubaSquare(const unsigned int *a, int n, unsigned int *out,
+                            unsigned int *work)
+{
+    if (n < karatsubaThreshold)
+    {
+        schoolbookSquare(a, n, out);
+        return;
+    } // end if (n < karatsubaThreshold)
+
+    int lo = n / 2, hi = n - lo;
+    unsigned int *sum = work;
+    unsigned int *mid = work + hi;
+    unsigned int *next = mid + 2 * hi - 1;
+
+    for (int i = 0; i < lo; ++i)
+    {
+        sum[i] = a[i] + a[lo + i];
+    } // end for (int i = 0)
+
+    // the high half is one longer when n is odd
+    if (hi > lo)
+    {
+        sum[lo] = a[n - 1];
+    } // end if (hi > lo)
+
+    // low and high squares go straight into their final positions
+    karatsubaSquare(a, lo, out, next);
+    out[2 * lo - 1] = 0;
+    karatsubaSquare(a + lo, hi, out + 2 * lo, next);
+    karatsubaSquare(sum, hi, mid, next);
+
+    for (int i = 0; i < 2 * lo - 1; ++i)
+    {
+        mid[i] -= out[i];
+    } // end for (int i = 0)
+
+    for (int i = 0; i < 2 * hi - 1; ++i)
+    {
+        mid[i] -= out[2 * lo + i];
+    } // end for (int i = 0)
+
+    for (int i = 0; i < 2 * hi - 1; ++i)
+    {
+        out[lo + i] += mid[i];
+    } // end for (int i = 0)
+} // end karatsubaSquare(const unsigned int*, int, ...)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays on the calling thread, choosing the
+ * kernel by operand size.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product.
+ */
+static void multiplySerial(const int *a, int n, const int *b, int m,
+                           int *out)
+{
+    int shorter = n < m ? n : m;
+
+    if (shorter < karatsubaThreshold)
+    {
+        mulSchoolbook(a, n, b, m, out);
+    }
+    else if (shorter >= nttThreshold && n + m - 1 <= NTT_MAX_LENGTH)
+    {
+        mulNtt(a, n, b, m, out);
+    }
+    else
+    {
+        mulKaratsuba(a, n, b, m, out);
+    } // end if (shorter < karatsubaThreshold)
+} // end multiplySerial(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array on the calling thread, choosing the kernel by
+ * operand size.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square.
+ */
+static void squareSerial(const int *a, int n, int *out)
+{
+    if (n < karatsubaThreshold)
+    {
+        sqrSchoolbook(a, n, out);
+    }
+    else if (n >= nttThreshold && 2 * n - 1 <= NTT_MAX_LENGTH)
+    {
+        sqrNtt(a, n, out);
+    }
+    else
+    {
+        sqrKaratsuba(a, n, out);
+    } // end if (n < karatsubaThreshold)
+} // end squareSerial(const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Mulders' short product of two coefficient arrays: the len lowest
+ * coefficients only. With k = 0.7 len, a = a0 + a1 x^k and b = b0 + b1 x^k,
+ * the low part of the product is that of a0b0 + (a1b0 + a0b1) x^k. a0b0 is
+ * computed in full; of a1b0 and a0b1 only the lowest len - k coefficients
+ * matter, so they are short products in turn. A square needs only one of
+ * them, added twice. Once the operands reach the NTT threshold, k moves to
+ * half the power of 2 at or above len, so that a0b0 fits a transform half
+ * as long as a full product would need; when that leaves the cross products
+ * too long, the NTT short product is used instead.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the len lowest coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out does not overlap a or b.
+ * @post out holds the low part of the product of a and b.
+ */
+static void shortProduct(const int *a, int n, const int *b, int m, int len,
+                         int *out)
+{
+    bool square = a == b && n == m;
+
+    n = n < len ? n : len;
+    m = m < len ? m : len;
+
+    int shorter = n < m ? n : m;
+
+    if (shorter < SHORT_SCHOOLBOOK * karatsubaThreshold)
+    {
+        schoolbookLow(reinterpret_cast<const unsigned int*>(a), n,
+                      reinterpret_cast<const unsigned int*>(b), m, len,
+                      reinterpret_cast<unsigned int*>(out));
+        return;
+    } // end if (shorter < SHORT_SCHOOLBOOK * karatsubaThreshold)
+
+    int k = len - len * (10 - SHORT_SPLIT) / 10;
+
+    if (shorter >= nttThreshold)
+    {
+        int size = 1;
+
+        while (size < len)
+        {
+            size <<= 1;
+        } // end while (size < len)
+
+        // past 3/4 of size, the cross products cost more than they save
+        if (4LL * (len - size / 2) > size
+            && n + m - 1 <= NTT_MAX_LENGTH)
+        {
+            mulLowNtt(a, n, b, m, len, out);
+            return;
+        } // end if (4LL * (len - size / 2) > size && ...)
+
+        k = size / 2;
+    } // end if (shorter >= nttThreshold)
+
+    int lowA = n < k ? n : k;
+    int lowB = m < k ? m : k;
+    int full = lowA + lowB - 1;
+
+    {
+        ScratchBuffer prod(full);
+
+        multiply(a, lowA, b, lowB, reinterpret_cast<int*>(prod.data()));
+
+        for (int i = 0; i < len; ++i)
+        {
+            out[i] = i < full ? static_cast<int>(prod.data()[i]) : 0;
+        } // end for (int i = 0)
+    }
+
+    int rest = len - k;
+
+    // a1 b0, then a0 b1; each reaches only x^k through x^(len - 1)
+    if (n > k)
+    {
+        int width = m < rest ? m : rest;
+        int count = n - k + width - 1 < rest ? n - k + width - 1 : rest;
+        ScratchBuffer piece(count);
+        int *cross = reinterpret_cast<int*>(piece.data());
+
+        shortProduct(a + k, n - k, b, width, count, cross);
+        addCoeffs(out + k, cross, count);
+
+        if (square)
+        {
+            addCoeffs(out + k, cross, count);
+        } // end if (square)
+    } // end if (n > k)
+
+    if (m > k && !square)
+    {
+        int width = n < rest ? n : rest;
+        int count = m - k + width - 1 < rest ? m - k + width - 1 : rest;
+        ScratchBuffer piece(count);
+        int *cross = reinterpret_cast<int*>(piece.data());
+
+        shortProduct(a, width, b + k, m - k, count, cross);
+        addCoeffs(out + k, cross, count);
+    } // end if (m > k && !square)
+} // end shortProduct(const int*, int, const int*, int, int, int*)
+
+// a product split into one slice of the longer operand a per task
+struct SplitProduct
+{
+    const int *a;
+    int n;
+    const int *b;
+    int m;
+    int slices;
+    int *partial;   // the product of each slice, one after the other
+    int *out;
+};
+
+/**----------------------------------------------------------------------------
+ * Locates a slice of a split product.
+ * @param split  The split product.
+ * @param index  The slice.
+ * @param start  Receives the power of a at which the slice starts.
+ * @param len  Receives the number of elements of a in the slice.
+ * @pre index is less than split.slices.
+ * @post start and len are set. The product of the slice, len + m - 1
+ *       elements, is at split.partial + start + index * (m - 1).
+ */
+static void locateSlice(const SplitProduct& split, int index, int& start,
+                        int& len)
+{
+    start = static_cast<int>(static_cast<long long>(split.n) * index
+                             / split.slices);
+    len = static_cast<int>(static_cast<long long>(split.n) * (index + 1)
+                           / split.slices) - start;
+} // end locateSlice(const SplitProduct&, int, int&, int&)
+
+/**----------------------------------------------------------------------------
+ * Task that multiplies one slice of a by b.
+ * @param context  The SplitProduct.
+ * @param index  The slice to multiply.
+ * @pre None.
+ * @post The product of the slice is in its place in split.partial.
+ */
+static void multiplySlice(void *context, int index)
+{
+    const SplitProduct& split = *static_cast<SplitProduct*>(context);
+    int start, len;
+
+    locateSlice(split, index, start, len);
+    multiplySerial(split.a + start, len, split.b, split.m,
+                   split.partial + start + index * (split.m - 1));
+} // end multiplySlice(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Task that sums the slice products over one range of output powers.
+ * @param context  The SplitProduct.
+ * @param index  The range of output powers; ranges are cut like slices.
+ * @pre Every slice product is complete.
+ * @post The range of split.out holds its coefficients of the product.
+ */
+static void sumSlices(void *context, int index)
+{
+    const SplitProduct& split = *static_cast<SplitProduct*>(context);
+    long long total = split.n + split.m - 1;
+    int lo = static_cast<int>(total * index / split.slices);
+    int hi = static_cast<int>(total * (index + 1) / split.slices);
+
+    for (int k = lo; k < hi; ++k)
+    {
+        split.out[k] = 0;
+    } // end for (int k = lo)
+
+    for (int slice = 0; slice < split.slices; ++slice)
+    {
+        int start, len;
+
+        locateSlice(split, slice, start, len);
+
+        // the powers this slice's product covers, within [lo, hi)
+        int first = start > lo ? start : lo;
+        int last = start + len + split.m - 1 < hi ? start + len + split.m - 1
+                                                  : hi;
+
+        if (first < last)
+        {
+            addCoeffs(split.out + first,
+                      split.partial + start + slice * (split.m - 1)
+                      + (first - start), last - first);
+        } // end if (first < last)
+    } // end for (int slice = 0)
+} // end sumSlices(void*, int)
+
+/**----------------------------------------------------------------------------
+ * Finds the length of the transform that a product of a number of
+ * coefficients needs.
+ * @param count  The number of coefficients.
+ * @pre None.
+ * @post None.
+ * @return The least power of 2 no less than count.
+ */
+static long long transformLength(long long count)
+{
+    long long len = 1;
+
+    while (len < count)
+    {
+        len <<= 1;
+    } // end while (len < count)
+
+    return len;
+} // end transformLength(long long)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the thread pool that products are split across, created at
+ * the thread count the first time it is needed.
+ * @pre None.
+ * @post The pool exists.
+ * @return The pool.
+ */
+static ThreadPool *sharedPool()
+{
+    lock_guard<mutex> guard(poolLock);
+
+    if (!pool)
+    {
+        pool.reset(new ThreadPool(threadCount));
+    } // end if (!pool)
+
+    return pool.get();
+} // end sharedPool()
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays across the thread pool. A product of
+ * operands that both reach the NTT threshold is done by one transform whose
+ * passes are spread over the threads, unless the transforms of the slices
+ * below would be no longer in total: each slice repeats a transform of the
+ * whole shorter operand, which only pays when the longer one is much longer.
+ * Otherwise the longer operand is cut into one slice per thread, each slice
+ * is multiplied by the shorter operand on its own thread, and the
+ * overlapping slice products are then summed, again one range of powers per
+ * thread. Sums wrap around modulo 2^32 whatever their order, so the result
+ * is bit-identical to the serial one.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product.
+ */
+static void multiplyParallel(const int *a, int n, const int *b, int m,
+                             int *out)
+{
+    // let a be the longer operand
+    if (n < m)
+    {
+        multiplyParallel(b, m, a, n, out);
+        return;
+    } // end if (n < m)
+
+    ThreadPool *workers = sharedPool();
+    int slices = workers->size() < n ? workers->size() : n;
+
+    if (m >= nttThreshold && n + m - 1 <= NTT_MAX_LENGTH
+        && slices * transformLength(n / slices + m - 1)
+           > transformLength(n + m - 1))
+    {
+        mulNtt(a, n, b, m, out, workers);
+        return;
+    } // end if (m >= nttThreshold && n + m - 1 <= NTT_MAX_LENGTH && ...)
+
+    ScratchBuffer partial(n + slices * (m - 1));
+    SplitProduct split = { a, n, b, m, slices,
+                           reinterpret_cast<int*>(partial.data()), out };
+
+    workers->run(slices, multiplySlice, &split);
+    workers->run(slices, sumSlices, &split);
+} // end multiplyParallel(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays, choosing the kernel by operand size.
+ * Products of at least the parallel threshold are split across threads.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product. a and b remain
+ *       unchanged.
+ */
+void multiply(const int *a, int n, const int *b, int m, int *out)
+{
+    if (a == b && n == m)
+    {
+        square(a, n, out);
+        return;
+    } // end if (a == b && n == m)
+
+    // a product already running on a worker stays on it
+    if (threadCount > 1 && n + m - 1 >= parallelThreshold
+        && !ThreadPool::runningTask())
+    {
+        multiplyParallel(a, n, b, m, out);
+    }
+    else
+    {
+        multiplySerial(a, n, b, m, out);
+    } // end if (threadCount > 1 && ...)
+} // end multiply(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array, choosing the kernel by operand size just as
+ * multiply() does. Squares of at least the parallel threshold are split
+ * across threads like any other product: inside the transform once a
+ * reaches the NTT threshold, and one slice of a times all of a per thread
+ * below it.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square. a remains
+ *       unchanged.
+ */
+void square(const int *a, int n, int *out)
+{
+    if (threadCount > 1 && 2 * n - 1 >= parallelThreshold
+        && !ThreadPool::runningTask())
+    {
+        multiplyParallel(a, n, a, n, out);
+    }
+    else
+    {
+        squareSerial(a, n, out);
+    } // end if (threadCount > 1 && ...)
+} // end square(const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays, as power-series arithmetic needs, choosing the kernel by operand
+ * size just as multiply() does. Elements of either operand at or above x^len
+ * cannot reach those coefficients and are ignored.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the coefficients of x^0 through x^(len - 1) of the
+ *       product. a and b remain unchanged.
+ */
+void mulLow(const int *a, int n, const int *b, int m, int len, int *out)
+{
+    n = n < len ? n : len;
+    m = m < len ? m : len;
+
+    // nothing above x^len to skip
+    if (len == n + m - 1)
+    {
+        multiply(a, n, b, m, out);
+        return;
+    } // end if (len == n + m - 1)
+
+    int shorter = n < m ? n : m;
+
+    if (shorter < SHORT_SCHOOLBOOK * karatsubaThreshold)
+    {
+        mulLowSchoolbook(a, n, b, m, len, out);
+    }
+    else
+    {
+        // falls back to mulLowNtt() where that is cheaper
+        mulLowKaratsuba(a, n, b, m, len, out);
+    } // end if (shorter < SHORT_SCHOOLBOOK * karatsubaThreshold)
+} // end mulLow(const int*, int, const int*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays with the schoolbook double loop, worked
+ * in cache-sized tiles of the output and the shorter operand. Also the base
+ * case of Karatsuba's algorithm.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product.
+ */
+void mulSchoolbook(const int *a, int n, const int *b, int m, int *out)
+{
+    schoolbook(reinterpret_cast<const unsigned int*>(a), n,
+               reinterpret_cast<const unsigned int*>(b), m,
+               reinterpret_cast<unsigned int*>(out));
+} // end mulSchoolbook(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array with the schoolbook loop, adding each cross
+ * term once and then doubling the sums. Also the base case of the Karatsuba
+ * square.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square.
+ */
+void sqrSchoolbook(const int *a, int n, int *out)
+{
+    schoolbookSquare(reinterpret_cast<const unsigned int*>(a), n,
+                     reinterpret_cast<unsigned int*>(out));
+} // end sqrSchoolbook(const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays with the schoolbook loop, skipping every pair of elements whose
+ * product lands at or above x^len; for operands of len elements, that is
+ * about half the work of the full product. Also the base case of
+ * mulLowKaratsuba().
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the len lowest coefficients of the product.
+ */
+void mulLowSchoolbook(const int *a, int n, const int *b, int m, int len,
+                      int *out)
+{
+    schoolbookLow(reinterpret_cast<const unsigned int*>(a), n,
+                  reinterpret_cast<const unsigned int*>(b), m, len,
+                  reinterpret_cast<unsigned int*>(out));
+} // end mulLowSchoolbook(const int*, int, const int*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Multiplies a coefficient array by another one in place with the schoolbook
+ * loop, working from the largest power down so that every element of a is
+ * read before it is overwritten. When b is a separate array of at least
+ * ROW_MIN_LENGTH elements, each element of a, from the top, is replaced by
+ * its row of the product and adds the rest of the row into the powers above
+ * it with scaleAddCoeffs(). Otherwise each coefficient of the product is
+ * summed on its own; it depends only on elements of a at or below its own
+ * power, which have not been overwritten yet. A square sums only the cross
+ * terms below the middle of each coefficient and doubles them.
+ * @param a  The coefficients of the first operand, replaced by the product.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand. May be a.
+ * @param m  The number of elements in b.
+ * @pre n and m are greater than 0. a has room for n + m - 1 elements.
+ * @post a holds the n + m - 1 coefficients of the product. b remains
+ *       unchanged unless it is a.
+ */
+void mulInPlace(int *a, int n, const int *b, int m)
+{
+    unsigned int *prod = reinterpret_cast<unsigned int*>(a);
+    const unsigned int *other = reinterpret_cast<const unsigned int*>(b);
+
+    if (b != a && m >= ROW_MIN_LENGTH)
+    {
+        for (int k = n; k < n + m - 1; ++k)
+        {
+            prod[k] = 0;
+        } // end for (int k = n)
+
+        for (int i = n - 1; i >= 0; --i)
+        {
+            int scale = a[i];
+
+            prod[i] = static_cast<unsigned int>(scale) * other[0];
+            scaleAddCoeffs(a + i + 1, b + 1, scale, m - 1);
+        } // end for (int i = n - 1)
+
+        return;
+    } // end if (b != a && m >= ROW_MIN_LENGTH)
+
+    if (b == a && m == n)
+    {
+        for (int k = 2 * n - 2; k >= 0; --k)
+        {
+            int first = k - n + 1 > 0 ? k - n + 1 : 0;
+            unsigned int sum = 0;
+
+            // pairs i < k - i, each standing for itself and its mirror
+            for (int i = first; 2 * i < k; ++i)
+            {
+                sum += prod[i] * prod[k - i];
+            } // end for (int i = first)
+
+            sum <<= 1;
+
+            if (k % 2 == 0)
+            {
+                sum += prod[k / 2] * prod[k / 2];
+            } // end if (k % 2 == 0)
+
+            prod[k] = sum;
+        } // end for (int k = 2 * n - 2)
+
+        return;
+    } // end if (b == a && m == n)
+
+    for (int k = n + m - 2; k >= 0; --k)
+    {
+        int first = k - m + 1 > 0 ? k - m + 1 : 0;
+        int last = k < n - 1 ? k : n - 1;
+        unsigned int sum = 0;
+
+        for (int i = first; i <= last; ++i)
+        {
+            sum += prod[i] * other[k - i];
+        } // end for (int i = first)
+
+        prod[k] = sum;
+    } // end for (int k = n + m - 2)
+} // end mulInPlace(int*, int, const int*, int)
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays with Karatsuba's algorithm. Operands are
+ * split in half until they fall below the Karatsuba threshold, at which point
+ * the schoolbook loop takes over. Unbalanced operands are handled by cutting
+ * the longer one into pieces the size of the shorter one.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product.
+ */
+void mulKaratsuba(const int *a, int n, const int *b, int m, int *out)
+{
+    // let a be the longer operand
+    if (n < m)
+    {
+        mulKaratsuba(b, m, a, n, out);
+        return;
+    } // end if (n < m)
+
+    const unsigned int *longer = reinterpret_cast<const unsigned int*>(a);
+    const unsigned int *shorter = reinterpret_cast<const unsigned int*>(b);
+    unsigned int *prod = reinterpret_cast<unsigned int*>(out);
+
+    ScratchBuffer work(karatsubaWorkSize(m) + 1);
+
+    if (n == m)
+    {
+        karatsuba(longer, shorter, m, prod, work.data());
+        return;
+    } // end if (n == m)
+
+    ScratchBuffer piece(2 * m - 1);
+
+    for (int k = 0; k < n + m - 1; ++k)
+    {
+        prod[k] = 0;
+    } // end for (int k = 0)
+
+    // multiply b by each m-sized piece of a and add it in at its offset
+    for (int start = 0; start < n; start += m)
+    {
+        int len = n - start < m ? n - start : m;
+
+        if (len == m)
+        {
+            karatsuba(longer + start, shorter, m, piece.data(), work.data());
+        }
+        else
+        {
+            multiply(b, m, a + start, len,
+                     reinterpret_cast<int*>(piece.data()));
+        } // end if (len == m)
+
+        for (int k = 0; k < len + m - 1; ++k)
+        {
+            prod[start + k] += piece.data()[k];
+        } // end for (int k = 0)
+    } // end for (int start = 0)
+} // end mulKaratsuba(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array with Karatsuba's algorithm: three half-size
+ * squares instead of three half-size products, down to the schoolbook
+ * square below the Karatsuba threshold.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square.
+ */
+void sqrKaratsuba(const int *a, int n, int *out)
+{
+    ScratchBuffer work(karatsubaWorkSize(n) + 1);
+
+    karatsubaSquare(reinterpret_cast<const unsigned int*>(a), n,
+                    reinterpret_cast<unsigned int*>(out), work.data());
+} // end sqrKaratsuba(const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays with Mulders' short product. The operands are split at a power k
+ * of about 0.7 len; the product of their parts below x^k, computed in full
+ * by multiply(), covers every low coefficient, and the two products of a
+ * part above x^k with the other operand's low part, each of which matters
+ * only below x^(len - k), are short products themselves. With Karatsuba
+ * underneath, that is about 80 percent of the work of the full product.
+ * Short operands go to the schoolbook short product, and from the NTT
+ * threshold k is moved to a power of 2 so that the full product needs a
+ * transform half as long, or mulLowNtt() is used where that is cheaper.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the len lowest coefficients of the product.
+ */
+void mulLowKaratsuba(const int *a, int n, const int *b, int m, int len,
+                     int *out)
+{
+    shortProduct(a, n, b, m, len, out);
+} // end mulLowKaratsuba(const int*, int, const int*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Mutator for the operand size at which multiply() switches from the
+ * schoolbook loop to Karatsuba. The same value is the base case size inside
+ * the Karatsuba recursion.
+ * @param threshold  The new threshold. Values below 2 are treated as 2.
+ * @pre None.
+ * @post Later calls to multiply() and mulKaratsuba() use the new threshold.
+ */
+void setKaratsubaThreshold(int threshold)
+{
+    if (threshold < 2)
+    {
+        threshold = 2;
+    } // end if (threshold < 2)
+
+    karatsubaThreshold = threshold;
+} // end setKaratsubaThreshold(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the Karatsuba threshold.
+ * @pre None.
+ * @post None.
+ * @return The operand size at which Karatsuba replaces the schoolbook loop.
+ */
+int getKaratsubaThreshold()
+{
+    return karatsubaThreshold;
+} // end getKaratsubaThreshold()
+
+/**----------------------------------------------------------------------------
+ * Mutator for the operand size at which multiply() switches from Karatsuba
+ * to the number-theoretic transform. Products longer than NTT_MAX_LENGTH
+ * always stay with Karatsuba.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to multiply() use the new threshold.
+ */
+void setNttThreshold(int threshold)
+{
+    if (threshold < 1)
+    {
+        threshold = 1;
+    } // end if (threshold < 1)
+
+    nttThreshold = threshold;
+} // end setNttThreshold(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the NTT threshold.
+ * @pre None.
+ * @post None.
+ * @return The operand size at which the number-theoretic transform replaces
+ *         Karatsuba.
+ */
+int getNttThreshold()
+{
+    return nttThreshold;
+} // end getNttThreshold()
+
+/**----------------------------------------------------------------------------
+ * Mutator for the number of threads multiply() may split a product across.
+ * @param threads  The new thread count, including the calling thread. Values
+ *                 below 1 are treated as 1, which keeps every product on the
+ *                 calling thread.
+ * @pre No call to multiply() is in progress.
+ * @post Later calls to multiply() use the new thread count.
+ */
+void setThreadCount(int threads)
+{
+    if (threads < 1)
+    {
+        threads = 1;
+    } // end if (threads < 1)
+
+    lock_guard<mutex> guard(poolLock);
+
+    threadCount = threads;
+    pool.reset();
+} // end setThreadCount(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the thread count.
+ * @pre None.
+ * @post None.
+ * @return The number of threads a product may be split across.
+ */
+int getThreadCount()
+{
+    return threadCount;
+} // end getThreadCount()
+
+/**----------------------------------------------------------------------------
+ * Mutator for the product length from which multiply() splits the work
+ * across threads.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to multiply() use the new threshold.
+ */
+void setParallelThreshold(int threshold)
+{
+    if (threshold < 1)
+    {
+        threshold = 1;
+    } // end if (threshold < 1)
+
+    parallelThreshold = threshold;
+} // end setParallelThreshold(int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the parallel threshold.
+ * @pre None.
+ * @post None.
+ * @return The product length from which products are split across threads.
+ */
+int getParallelThreshold()
+{
+    return parallelThreshold;
+} // end getParallelThreshold()
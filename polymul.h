@@ -0,0 +1,264 @@
+/**
+ * @file    polymul.h
+ * @brief   Multiplication kernels for the coefficient arrays behind Poly. Each
+ *          kernel takes two arrays of ints, where the index of an element is
+ *          its power, and writes their product into an output array that has
+ *          room for every power of the result. Arithmetic wraps around on
+ *          overflow exactly as the original int loop in Poly::operator* did.
+ *          multiply() picks the cheapest kernel for the sizes it is given:
+ *          the schoolbook double loop for small operands, Karatsuba
+ *          divide-and-conquer above a tunable threshold and the number-
+ *          theoretic transform in ntt.h above a second, larger one. Long
+ *          products are also split across a pool of threads; the result is
+ *          the same, bit for bit, as on one thread. Squares have kernels of
+ *          their own, which need about half the multiplications, as do
+ *          truncated products, which compute only the lowest coefficients.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYMUL_H
+#define	_POLYMUL_H
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays, choosing the kernel by operand size.
+ * Products of at least the parallel threshold are split across threads; see
+ * setThreadCount(). When b is a and m is n, the square kernels are used.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product. a and b remain
+ *       unchanged.
+ */
+void multiply(const int *a, int n, const int *b, int m, int *out);
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array, choosing the kernel by operand size just as
+ * multiply() does. Each cross term a[i] * a[j] is computed once and doubled,
+ * so every kernel does about half the work of a general product.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square. a remains
+ *       unchanged.
+ */
+void square(const int *a, int n, int *out);
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays, as power-series arithmetic needs, choosing the kernel by operand
+ * size just as multiply() does. Elements of either operand at or above x^len
+ * cannot reach those coefficients and are ignored.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the coefficients of x^0 through x^(len - 1) of the
+ *       product. a and b remain unchanged.
+ */
+void mulLow(const int *a, int n, const int *b, int m, int len, int *out);
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays with the schoolbook double loop, worked
+ * in cache-sized tiles of the output and the shorter operand. Also the base
+ * case of Karatsuba's algorithm.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product.
+ */
+void mulSchoolbook(const int *a, int n, const int *b, int m, int *out);
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array with the schoolbook loop, adding each cross
+ * term once and then doubling the sums. Also the base case of the Karatsuba
+ * square.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square.
+ */
+void sqrSchoolbook(const int *a, int n, int *out);
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays with the schoolbook loop, skipping every pair of elements whose
+ * product lands at or above x^len; for operands of len elements, that is
+ * about half the work of the full product. Also the base case of
+ * mulLowKaratsuba().
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the len lowest coefficients of the product.
+ */
+void mulLowSchoolbook(const int *a, int n, const int *b, int m, int len,
+                      int *out);
+
+/**----------------------------------------------------------------------------
+ * Multiplies a coefficient array by another one in place with the schoolbook
+ * loop, computing the product from the largest power down so that no
+ * separate output array is needed. When b is a and m is n, the array is
+ * squared with half the multiplications.
+ * @param a  The coefficients of the first operand, replaced by the product.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand. May be a.
+ * @param m  The number of elements in b.
+ * @pre n and m are greater than 0. a has room for n + m - 1 elements.
+ * @post a holds the n + m - 1 coefficients of the product. b remains
+ *       unchanged unless it is a.
+ */
+void mulInPlace(int *a, int n, const int *b, int m);
+
+/**----------------------------------------------------------------------------
+ * Multiplies two coefficient arrays with Karatsuba's algorithm. Operands are
+ * split in half until they fall below the Karatsuba threshold, at which point
+ * the schoolbook loop takes over. Unbalanced operands are handled by cutting
+ * the longer one into pieces the size of the shorter one.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param out  The array to receive the product.
+ * @pre n and m are greater than 0. out has room for n + m - 1 elements and
+ *      does not overlap a or b.
+ * @post out holds the n + m - 1 coefficients of the product.
+ */
+void mulKaratsuba(const int *a, int n, const int *b, int m, int *out);
+
+/**----------------------------------------------------------------------------
+ * Squares a coefficient array with Karatsuba's algorithm: three half-size
+ * squares instead of three half-size products, down to the schoolbook
+ * square below the Karatsuba threshold.
+ * @param a  The coefficients of the operand.
+ * @param n  The number of elements in a.
+ * @param out  The array to receive the square.
+ * @pre n is greater than 0. out has room for 2n - 1 elements and does not
+ *      overlap a.
+ * @post out holds the 2n - 1 coefficients of the square.
+ */
+void sqrKaratsuba(const int *a, int n, int *out);
+
+/**----------------------------------------------------------------------------
+ * Computes the len lowest coefficients of the product of two coefficient
+ * arrays with Mulders' short product. The operands are split at a power k
+ * of about 0.7 len; the product of their parts below x^k, computed in full
+ * by multiply(), covers every low coefficient, and the two products of a
+ * part above x^k with the other operand's low part, each of which matters
+ * only below x^(len - k), are short products themselves. With Karatsuba
+ * underneath, that is about 80 percent of the work of the full product.
+ * Short operands go to the schoolbook short product, and from the NTT
+ * threshold k is moved to a power of 2 so that the full product needs a
+ * transform half as long, or mulLowNtt() is used where that is cheaper.
+ * @param a  The coefficients of the first operand.
+ * @param n  The number of elements in a.
+ * @param b  The coefficients of the second operand.
+ * @param m  The number of elements in b.
+ * @param len  The number of coefficients to compute.
+ * @param out  The array to receive the coefficients.
+ * @pre n, m and len are greater than 0 and len is no more than n + m - 1.
+ *      out has room for len elements and does not overlap a or b.
+ * @post out holds the len lowest coefficients of the product.
+ */
+void mulLowKaratsuba(const int *a, int n, const int *b, int m, int len,
+                     int *out);
+
+/**----------------------------------------------------------------------------
+ * Mutator for the operand size at which multiply() switches from the
+ * schoolbook loop to Karatsuba. The same value is the base case size inside
+ * the Karatsuba recursion.
+ * @param threshold  The new threshold. Values below 2 are treated as 2.
+ * @pre None.
+ * @post Later calls to multiply() and mulKaratsuba() use the new threshold.
+ */
+void setKaratsubaThreshold(int threshold);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the Karatsuba threshold.
+ * @pre None.
+ * @post None.
+ * @return The operand size at which Karatsuba replaces the schoolbook loop.
+ */
+int getKaratsubaThreshold();
+
+/**----------------------------------------------------------------------------
+ * Mutator for the operand size at which multiply() switches from Karatsuba
+ * to the number-theoretic transform. Products longer than NTT_MAX_LENGTH
+ * always stay with Karatsuba.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to multiply() use the new threshold.
+ */
+void setNttThreshold(int threshold);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the NTT threshold.
+ * @pre None.
+ * @post None.
+ * @return The operand size at which the number-theoretic transform replaces
+ *         Karatsuba.
+ */
+int getNttThreshold();
+
+/**----------------------------------------------------------------------------
+ * Mutator for the number of threads multiply() may split a product across.
+ * Operands that both reach the NTT threshold share one transform whose
+ * passes run on every thread; otherwise the longer operand is cut into one
+ * slice per thread and the slice products are summed. Since the sums wrap
+ * around modulo 2^32 in any order, the result is bit-identical to
+ * multiplying on one thread. Defaults to the number of cores.
+ * @param threads  The new thread count, including the calling thread. Values
+ *                 below 1 are treated as 1, which keeps every product on the
+ *                 calling thread.
+ * @pre No call to multiply() is in progress.
+ * @post Later calls to multiply() use the new thread count.
+ */
+void setThreadCount(int threads);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the thread count.
+ * @pre None.
+ * @post None.
+ * @return The number of threads a product may be split across.
+ */
+int getThreadCount();
+
+/**----------------------------------------------------------------------------
+ * Mutator for the product length (n + m - 1) from which multiply() splits
+ * the work across threads. Shorter products stay on the calling thread,
+ * where they finish sooner than it takes to wake the others.
+ * @param threshold  The new threshold. Values below 1 are treated as 1.
+ * @pre None.
+ * @post Later calls to multiply() use the new threshold.
+ */
+void setParallelThreshold(int threshold);
+
+/**----------------------------------------------------------------------------
+ * Accessor for the parallel threshold.
+ * @pre None.
+ * @post None.
+ * @return The product length from which products are split across threads.
+ */
+int getParallelThreshold();
+
+#endif	/* _POLYMUL_H */
@@ -0,0 +1,342 @@
+/**
+ * @file    polyparse.cpp
+ * @brief   Text decoding for Poly: the "coeff exp coeff exp ... 0 0" lists
+ *          that operator>> reads. Integers are decoded by hand rather than
+ *          with formatted extraction, which goes through the locale and a
+ *          virtual call for every number. A character buffer is scanned
+ *          directly, with runs of digits found a vector of bytes at a time
+ *          where the CPU allows; a stream is read a character at a time
+ *          from its buffer, without the per-number sentry and facet lookup.
+ *          Both give the pairs in the order read, for Poly to place in
+ *          storage sized once for all of them.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include <climits>
+#include <cstring>
+#include "polyparse.h"
+
+// SSE2 is part of every x86-64 CPU, so the digit scan needs no dispatch;
+// the eight-digit decoder also relies on x86 being little-endian
+#if defined(__GNUC__) && defined(__SSE2__)
+#define	POLYPARSE_SSE2
+#include <emmintrin.h>
+#endif
+
+// largest magnitude an int can hold, which is that of its minimum
+static const unsigned long long INT_MAGNITUDE = 2147483648ULL;
+
+/**----------------------------------------------------------------------------
+ * Checks for the white space that formatted extraction skips in the C
+ * locale.
+ * @param c  The character to check.
+ * @pre None.
+ * @post None.
+ * @return true if c is a space, tab, newline, vertical tab, form feed or
+ *         carriage return; false, otherwise.
+ */
+static bool isSpace(int c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+} // end isSpace(int)
+
+/**----------------------------------------------------------------------------
+ * Checks for a decimal digit.
+ * @param c  The character to check.
+ * @pre None.
+ * @post None.
+ * @return true if c is 0 through 9; false, otherwise.
+ */
+static bool isDigit(int c)
+{
+    return static_cast<unsigned int>(c - '0') < 10;
+} // end isDigit(int)
+
+/**----------------------------------------------------------------------------
+ * Measures the run of digits at the start of a buffer. With SSE2, 16
+ * characters are compared at once and the first non-digit is found from the
+ * resulting bit mask; the last few characters of the buffer are checked one
+ * at a time.
+ * @param begin  The first character of the run.
+ * @param end  One past the last character that may be read.
+ * @pre begin is no greater than end.
+ * @post None.
+ * @return The number of digits from begin on.
+ */
+static long digitRun(const char *begin, const char *end)
+{
+    const char *p = begin;
+
+#ifdef POLYPARSE_SSE2
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i chunk = _mm_sub_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero);
+
+        // a digit is one that no unsigned minimum with 9 can lower
+        int mask = _mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_min_epu8(chunk, nine), chunk));
+
+        if (mask != 0xFFFF)
+        {
+            return p - begin + __builtin_ctz(~mask);
+        } // end if (mask != 0xFFFF)
+    } // end for (; end - p >= 16)
+#endif
+
+    while (p < end && isDigit(*p))
+    {
+        ++p;
+    } // end while (p < end && isDigit(*p))
+
+    return p - begin;
+} // end digitRun(const char*, const char*)
+
+/**----------------------------------------------------------------------------
+ * Decodes eight digits at once as one 64-bit word: adjacent digits are
+ * joined into pairs, pairs into fours and fours into the whole with three
+ * multiplications, instead of a chain of eight multiply-adds. x86 is
+ * little-endian, so the first digit is the lowest byte of the word.
+ * @param digits  The first of the eight digits.
+ * @pre digits points at eight decimal digits.
+ * @post None.
+ * @return The number they spell, from 0 to 99999999.
+ */
+static unsigned long long eightDigits(const char *digits)
+{
+    unsigned long long word;
+
+    memcpy(&word, digits, sizeof(word));
+    word -= 0x3030303030303030ULL;
+    word = word * 10 + (word >> 8);
+    word = ((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))
+            + ((word >> 16) & 0x000000FF000000FFULL)
+              * (1 + (10000ULL << 32))) >> 32;
+
+    return word;
+} // end eightDigits(const char*)
+
+/**----------------------------------------------------------------------------
+ * Decodes one integer from a character buffer: leading white space, an
+ * optional + or - sign, then decimal digits.
+ * @param begin  The first character to read.
+ * @param end  One past the last character that may be read.
+ * @param value  The int to receive the integer.
+ * @pre begin is no greater than end.
+ * @post value holds the integer if one was found.
+ * @return One past the last digit of the integer, or NULL if the buffer ran
+ *         out, held something other than an integer or held one that does
+ *         not fit in an int.
+ */
+const char *scanInt(const char *begin, const char *end, int& value)
+{
+    const char *p = begin;
+    bool negative = false;
+
+    while (p < end && isSpace(*p))
+    {
+        ++p;
+    } // end while (p < end && isSpace(*p))
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p++ == '-';
+    } // end if (p < end && (*p == '-' || *p == '+'))
+
+    long run = digitRun(p, end);
+    unsigned long long magnitude = 0;
+
+    if (run == 0)
+    {
+        return NULL;
+    } // end if (run == 0)
+
+    const char *last = p + run;
+
+#ifdef POLYPARSE_SSE2
+    for (; last - p >= 8; p += 8)
+    {
+        magnitude = magnitude * 100000000 + eightDigits(p);
+
+        if (magnitude > INT_MAGNITUDE)
+        {
+            return NULL;
+        } // end if (magnitude > INT_MAGNITUDE)
+    } // end for (; last - p >= 8)
+#endif
+
+    for (; p < last; ++p)
+    {
+        magnitude = magnitude * 10 + (*p - '0');
+
+        if (magnitude > INT_MAGNITUDE)
+        {
+            return NULL;
+        } // end if (magnitude > INT_MAGNITUDE)
+    } // end for (; p < last)
+
+    if (!negative && magnitude == INT_MAGNITUDE)
+    {
+        return NULL;
+    } // end if (!negative && magnitude == INT_MAGNITUDE)
+
+    value = static_cast<int>(negative ? 0 - magnitude : magnitude);
+    return p;
+} // end scanInt(const char*, const char*, int&)
+
+/**----------------------------------------------------------------------------
+ * Decodes coefficient and power pairs from a character buffer up to and
+ * including a pair of 0 0, which is not stored.
+ * @param begin  The first character to read.
+ * @param end  One past the last character that may be read.
+ * @param pairs  The vector to receive the pairs, coefficient first.
+ * @pre begin is no greater than end.
+ * @post pairs holds the pairs read, appended in order, including those read
+ *       before a failure.
+ * @return One past the last digit of the terminating 0 0, or NULL if the
+ *         buffer ran out, held something other than integers or held a
+ *         power of INT_MAX or -INT_MAX first.
+ */
+const char *scanTerms(const char *begin, const char *end, vector<int>& pairs)
+{
+    const char *p = begin;
+    int coeff, exp;
+
+    while ((p = scanInt(p, end, coeff)) != NULL
+           && (p = scanInt(p, end, exp)) != NULL)
+    {
+        if (coeff == 0 && exp == 0)
+        {
+            return p;
+        } // end if (coeff == 0 && exp == 0)
+
+        // a Poly holds powers below INT_MAX only
+        if (exp == INT_MAX || exp == -INT_MAX)
+        {
+            return NULL;
+        } // end if (exp == INT_MAX || exp == -INT_MAX)
+
+        pairs.push_back(coeff);
+        pairs.push_back(exp);
+    } // end while ((p = scanInt(p, end, coeff)) != NULL ...)
+
+    return NULL;
+} // end scanTerms(const char*, const char*, vector<int>&)
+
+/**----------------------------------------------------------------------------
+ * Decodes one integer from a stream buffer, as scanInt() does from a
+ * character buffer. sgetc() and sbumpc() only make a virtual call when the
+ * buffer needs refilling.
+ * @param buffer  The stream buffer to read.
+ * @param value  The int to receive the integer.
+ * @param ended  Set to true if the buffer ran out.
+ * @pre None.
+ * @post value holds the integer if one was found. The buffer is left at the
+ *       first character after it, or after the whole run of digits if they
+ *       do not fit in an int.
+ * @return true if an integer that fits in an int was found; false,
+ *         otherwise.
+ */
+static bool scanInt(streambuf *buffer, int& value, bool& ended)
+{
+    const int eof = char_traits<char>::eof();
+    int c = buffer->sgetc();
+    bool negative = false;
+    unsigned long long magnitude = 0;
+
+    while (c != eof && isSpace(c))
+    {
+        c = buffer->snextc();
+    } // end while (c != eof && isSpace(c))
+
+    if (c == '-' || c == '+')
+    {
+        negative = c == '-';
+        c = buffer->snextc();
+    } // end if (c == '-' || c == '+')
+
+    if (!isDigit(c))
+    {
+        ended = c == eof;
+        return false;
+    } // end if (!isDigit(c))
+
+    // the whole run is taken even past an overflow, so that no digits of
+    // it are left behind for the next read
+    for (; isDigit(c); c = buffer->snextc())
+    {
+        if (magnitude <= INT_MAGNITUDE)
+        {
+            magnitude = magnitude * 10 + (c - '0');
+        } // end if (magnitude <= INT_MAGNITUDE)
+    } // end for (; isDigit(c))
+
+    ended = c == eof;
+
+    if (magnitude > INT_MAGNITUDE
+        || (!negative && magnitude == INT_MAGNITUDE))
+    {
+        return false;
+    } // end if (!negative && magnitude == INT_MAGNITUDE)
+
+    value = static_cast<int>(negative ? 0 - magnitude : magnitude);
+    return true;
+} // end scanInt(streambuf*, int&, bool&)
+
+/**----------------------------------------------------------------------------
+ * Decodes coefficient and power pairs from a stream up to and including a
+ * pair of 0 0, which is not stored. Characters are taken from the stream's
+ * buffer one at a time, and reading stops right after the last digit, just
+ * where formatted extraction would have left the stream.
+ * @param input  The stream to read.
+ * @param pairs  The vector to receive the pairs, coefficient first.
+ * @pre None.
+ * @post pairs holds the pairs read, appended in order. If the stream ran
+ *       out, held something other than integers or held a power of INT_MAX
+ *       or -INT_MAX first, failbit is set on input, and eofbit too if it ran
+ *       out.
+ * @return true if the terminating 0 0 was read; false, otherwise.
+ */
+bool scanTerms(istream& input, vector<int>& pairs)
+{
+    // one sentry flushes a tied prompt and checks the state for the lot
+    istream::sentry ready(input, true);
+    bool ended = false;
+    int coeff, exp;
+
+    if (!ready)
+    {
+        return false;
+    } // end if (!ready)
+
+    streambuf *buffer = input.rdbuf();
+
+    while (scanInt(buffer, coeff, ended) && scanInt(buffer, exp, ended))
+    {
+        if (coeff == 0 && exp == 0)
+        {
+            if (ended)
+            {
+                input.setstate(ios::eofbit);
+            } // end if (ended)
+
+            return true;
+        } // end if (coeff == 0 && exp == 0)
+
+        // a Poly holds powers below INT_MAX only
+        if (exp == INT_MAX || exp == -INT_MAX)
+        {
+            break;
+        } // end if (exp == INT_MAX || exp == -INT_MAX)
+
+        pairs.push_back(coeff);
+        pairs.push_back(exp);
+    } // end while (scanInt(buffer, coeff, ended) && ...)
+
+    input.setstate(ended ? ios::failbit | ios::eofbit : ios::failbit);
+    return false;
+} // end scanTerms(istream&, vector<int>&)
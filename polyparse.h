@@ -0,0 +1,69 @@
+/**
+ * @file    polyparse.h
+ * @brief   Text decoding for Poly: the "coeff exp coeff exp ... 0 0" lists
+ *          that operator>> reads. Integers are decoded by hand rather than
+ *          with formatted extraction, which goes through the locale and a
+ *          virtual call for every number. A character buffer is scanned
+ *          directly, with runs of digits found a vector of bytes at a time
+ *          where the CPU allows; a stream is read a character at a time
+ *          from its buffer, without the per-number sentry and facet lookup.
+ *          Both give the pairs in the order read, for Poly to place in
+ *          storage sized once for all of them.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYPARSE_H
+#define	_POLYPARSE_H
+
+#include <istream>
+#include <vector>
+
+using namespace std;
+
+/**----------------------------------------------------------------------------
+ * Decodes one integer from a character buffer: leading white space, an
+ * optional + or - sign, then decimal digits.
+ * @param begin  The first character to read.
+ * @param end  One past the last character that may be read.
+ * @param value  The int to receive the integer.
+ * @pre begin is no greater than end.
+ * @post value holds the integer if one was found.
+ * @return One past the last digit of the integer, or NULL if the buffer ran
+ *         out, held something other than an integer or held one that does
+ *         not fit in an int.
+ */
+const char *scanInt(const char *begin, const char *end, int& value);
+
+/**----------------------------------------------------------------------------
+ * Decodes coefficient and power pairs from a character buffer up to and
+ * including a pair of 0 0, which is not stored.
+ * @param begin  The first character to read.
+ * @param end  One past the last character that may be read.
+ * @param pairs  The vector to receive the pairs, coefficient first.
+ * @pre begin is no greater than end.
+ * @post pairs holds the pairs read, appended in order, including those read
+ *       before a failure.
+ * @return One past the last digit of the terminating 0 0, or NULL if the
+ *         buffer ran out, held something other than integers or held a
+ *         power of INT_MAX or -INT_MAX first.
+ */
+const char *scanTerms(const char *begin, const char *end, vector<int>& pairs);
+
+/**----------------------------------------------------------------------------
+ * Decodes coefficient and power pairs from a stream up to and including a
+ * pair of 0 0, which is not stored. Characters are taken from the stream's
+ * buffer one at a time, and reading stops right after the last digit, just
+ * where formatted extraction would have left the stream.
+ * @param input  The stream to read.
+ * @param pairs  The vector to receive the pairs, coefficient first.
+ * @pre None.
+ * @post pairs holds the pairs read, appended in order. If the stream ran
+ *       out, held something other than integers or held a power of INT_MAX
+ *       or -INT_MAX first, failbit is set on input, and eofbit too if it ran
+ *       out.
+ * @return true if the terminating 0 0 was read; false, otherwise.
+ */
+bool scanTerms(istream& input, vector<int>& pairs);
+
+#endif	/* _POLYPARSE_H */
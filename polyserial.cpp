@@ -0,0 +1,283 @@
+/**
+ * @file    polyserial.cpp
+ * @brief   Binary format for Poly, for checkpoints and for passing
+ *          polynomials between programs without formatting or parsing text.
+ *          See polyserial.h for the layout. Multi-byte fields are assembled
+ *          a byte at a time with shifts, which compilers turn into single
+ *          loads and stores on little-endian machines; width-4 coefficient
+ *          blocks are copied whole there.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include <climits>
+#include <cstring>
+#include "polyserial.h"
+
+// the first four bytes of every file
+static const char MAGIC[] = { 'P', 'O', 'L', 'Y' };
+
+/**----------------------------------------------------------------------------
+ * Checks the byte order of the machine.
+ * @pre None.
+ * @post None.
+ * @return true if ints are stored lowest byte first; false, otherwise.
+ */
+static bool littleEndian()
+{
+    const int one = 1;
+    char first;
+
+    memcpy(&first, &one, 1);
+    return first == 1;
+} // end littleEndian()
+
+/**----------------------------------------------------------------------------
+ * Stores a 32-bit number, lowest byte first.
+ * @param value  The number to store.
+ * @param out  The array to receive it.
+ * @pre out has room for 4 bytes.
+ * @post out holds the number.
+ */
+void putWord(unsigned int value, char *out)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out[i] = static_cast<char>(value >> 8 * i);
+    } // end for (int i = 0)
+} // end putWord(unsigned int, char*)
+
+/**----------------------------------------------------------------------------
+ * Loads a 32-bit number stored lowest byte first.
+ * @param in  The stored number.
+ * @pre in has 4 bytes.
+ * @post None.
+ * @return The number.
+ */
+unsigned int getWord(const char *in)
+{
+    unsigned int value = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        value |= static_cast<unsigned int>(static_cast<unsigned char>(in[i]))
+                 << 8 * i;
+    } // end for (int i = 0)
+
+    return value;
+} // end getWord(const char*)
+
+/**----------------------------------------------------------------------------
+ * Encodes a header.
+ * @param header  The fields to encode.
+ * @param out  The array to receive the header.
+ * @pre out has room for SERIAL_HEADER_SIZE bytes.
+ * @post out holds the header, with the magic and SERIAL_VERSION.
+ */
+void writeHeader(const SerialHeader& header, char *out)
+{
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    out[4] = static_cast<char>(SERIAL_VERSION);
+    out[5] = static_cast<char>(header.form);
+    out[6] = static_cast<char>(header.width);
+    out[7] = 0;
+    putWord(static_cast<unsigned int>(header.degree), out + 8);
+    putWord(static_cast<unsigned int>(header.count), out + 12);
+} // end writeHeader(const SerialHeader&, char*)
+
+/**----------------------------------------------------------------------------
+ * Decodes and checks a header.
+ * @param in  The encoded header.
+ * @param header  The fields to receive the header.
+ * @pre in has SERIAL_HEADER_SIZE bytes.
+ * @post header holds the fields if they are valid.
+ * @return true if the magic and version match, the degree is below INT_MAX
+ *         and the form, width, degree and count are consistent; false,
+ *         otherwise.
+ */
+bool readHeader(const char *in, SerialHeader& header)
+{
+    SerialHeader read;
+
+    read.form = in[5];
+    read.width = in[6];
+    read.degree = static_cast<int>(getWord(in + 8));
+    read.count = static_cast<int>(getWord(in + 12));
+
+    if (memcmp(in, MAGIC, sizeof(MAGIC)) != 0 || in[4] != SERIAL_VERSION
+        || (read.width != 1 && read.width != 2 && read.width != 4)
+        || read.degree < -1 || read.degree == INT_MAX || read.count < 0)
+    {
+        return false;
+    } // end if (memcmp(in, MAGIC, sizeof(MAGIC)) != 0 || ...)
+
+    // there are no more terms than powers, and only 0 has none
+    if ((read.form != SERIAL_DENSE && read.form != SERIAL_SPARSE)
+        || read.count > read.degree + 1LL
+        || (read.count == 0) != (read.degree == -1))
+    {
+        return false;
+    } // end if ((read.form != SERIAL_DENSE && ...)
+
+    header = read;
+    return true;
+} // end readHeader(const char*, SerialHeader&)
+
+/**----------------------------------------------------------------------------
+ * Checks whether a body can be used as a coefficient list where it lies.
+ * @param header  The header of the body.
+ * @pre None.
+ * @post None.
+ * @return true if the body is dense, 4 bytes per coefficient and this
+ *         machine is little-endian; false, otherwise.
+ */
+bool isNative(const SerialHeader& header)
+{
+    return header.form == SERIAL_DENSE && header.width == 4 && littleEndian();
+} // end isNative(const SerialHeader&)
+
+/**----------------------------------------------------------------------------
+ * Finds the narrowest width that holds every element of an array.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @pre None.
+ * @post None.
+ * @return 1, 2 or 4.
+ */
+int coeffWidth(const int *coeffs, int n)
+{
+    int low = 0, high = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        low = coeffs[i] < low ? coeffs[i] : low;
+        high = coeffs[i] > high ? coeffs[i] : high;
+    } // end for (int i = 0)
+
+    if (low >= -128 && high <= 127)
+    {
+        return 1;
+    } // end if (low >= -128 && high <= 127)
+
+    return low >= -32768 && high <= 32767 ? 2 : 4;
+} // end coeffWidth(const int*, int)
+
+/**----------------------------------------------------------------------------
+ * Encodes coefficients as little-endian signed integers of a width.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param width  The width; 1, 2 or 4.
+ * @param out  The array to receive the encoding.
+ * @pre Every element fits in width bytes. out has room for n * width bytes.
+ * @post out holds the encoding.
+ */
+void packCoeffs(const int *coeffs, int n, int width, char *out)
+{
+    if (width == 4 && littleEndian())
+    {
+        memcpy(out, coeffs, static_cast<size_t>(n) * 4);
+        return;
+    } // end if (width == 4 && littleEndian())
+
+    for (int i = 0; i < n; ++i)
+    {
+        unsigned int value = static_cast<unsigned int>(coeffs[i]);
+
+        for (int b = 0; b < width; ++b)
+        {
+            *out++ = static_cast<char>(value >> 8 * b);
+        } // end for (int b = 0)
+    } // end for (int i = 0)
+} // end packCoeffs(const int*, int, int, char*)
+
+/**----------------------------------------------------------------------------
+ * Decodes coefficients stored as little-endian signed integers of a width.
+ * @param in  The encoding.
+ * @param n  The number of coefficients.
+ * @param width  The width; 1, 2 or 4.
+ * @param out  The array to receive the coefficients.
+ * @pre in has n * width bytes. out has room for n elements. in is either
+ *      apart from out or the last n * width bytes of it, so that a body read
+ *      into the end of a coefficient list can be widened where it lies.
+ * @post out holds the coefficients.
+ */
+void unpackCoeffs(const char *in, int n, int width, int *out)
+{
+    if (width == 4 && littleEndian())
+    {
+        memmove(out, in, static_cast<size_t>(n) * 4);
+    }
+    else if (width == 4)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            out[i] = static_cast<int>(getWord(in + 4 * i));
+        } // end for (int i = 0)
+    }
+    else if (width == 2)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            unsigned int low = static_cast<unsigned char>(in[2 * i]);
+            unsigned int high = static_cast<unsigned char>(in[2 * i + 1]);
+
+            out[i] = static_cast<short>(low | high << 8);
+        } // end for (int i = 0)
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            out[i] = static_cast<signed char>(in[i]);
+        } // end for (int i = 0)
+    } // end if (width == 4 && littleEndian())
+} // end unpackCoeffs(const char*, int, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Encodes a number as a varint.
+ * @param value  The number to encode.
+ * @param out  The array to receive the encoding.
+ * @pre out has room for 5 bytes.
+ * @post out holds the encoding.
+ * @return One past the last byte written.
+ */
+char *putVarint(unsigned int value, char *out)
+{
+    for (; value >= 0x80; value >>= 7)
+    {
+        *out++ = static_cast<char>(value | 0x80);
+    } // end for (; value >= 0x80)
+
+    *out++ = static_cast<char>(value);
+    return out;
+} // end putVarint(unsigned int, char*)
+
+/**----------------------------------------------------------------------------
+ * Decodes a varint.
+ * @param in  The first byte of the encoding.
+ * @param end  One past the last byte that may be read.
+ * @param value  The number to receive the value.
+ * @pre in is no greater than end.
+ * @post value holds the number if the encoding was valid.
+ * @return One past the last byte of the encoding, or NULL if it ran past end
+ *         or was longer than 5 bytes.
+ */
+const char *getVarint(const char *in, const char *end, unsigned int& value)
+{
+    unsigned int result = 0;
+
+    for (int shift = 0; in < end && shift < 35; shift += 7)
+    {
+        unsigned int byte = static_cast<unsigned char>(*in++);
+
+        result |= (byte & 0x7F) << shift;
+
+        if (byte < 0x80)
+        {
+            value = result;
+            return in;
+        } // end if (byte < 0x80)
+    } // end for (int shift = 0; in < end && shift < 35)
+
+    return NULL;
+} // end getVarint(const char*, const char*, unsigned int&)
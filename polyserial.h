@@ -0,0 +1,160 @@
+/**
+ * @file    polyserial.h
+ * @brief   Binary format for Poly, for checkpoints and for passing
+ *          polynomials between programs without formatting or parsing text.
+ *          Every field is little-endian. A file starts with a 16-byte header:
+ *
+ *              offset  size  field
+ *              0       4     magic, "POLY"
+ *              4       1     version, SERIAL_VERSION
+ *              5       1     form, SERIAL_DENSE or SERIAL_SPARSE
+ *              6       1     coefficient width in bytes: 1, 2 or 4
+ *              7       1     reserved, 0
+ *              8       4     degree, signed; -1 for 0
+ *              12      4     count of non-zero coefficients
+ *
+ *          A dense body is the degree + 1 coefficients from x^0 up, each a
+ *          signed integer of the given width; at width 4 it is the
+ *          coefficient list itself, byte for byte, on a little-endian
+ *          machine. A sparse body is the byte length of the powers as 4
+ *          bytes, then the powers from the lowest up as varints (7 bits per
+ *          byte, low bits first, the top bit set on all but the last byte),
+ *          each the difference from the one before, then the count
+ *          coefficients at the given width. The width is the narrowest that
+ *          holds every coefficient.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYSERIAL_H
+#define	_POLYSERIAL_H
+
+// size of the header, which keeps a dense body 4-byte aligned in a file
+const int SERIAL_HEADER_SIZE = 16;
+
+// most bytes a reader takes memory for before the stream has shown that it
+// holds them; larger bodies are read in pieces that grow with what arrived
+const int SERIAL_CHUNK = 1 << 18;
+
+// version written to and accepted from the header
+const int SERIAL_VERSION = 1;
+
+// values of the form field
+const int SERIAL_DENSE = 0;
+const int SERIAL_SPARSE = 1;
+
+// the fields of a header, decoded
+struct SerialHeader
+{
+    int form;           // SERIAL_DENSE or SERIAL_SPARSE
+    int width;          // bytes per coefficient
+    int degree;         // largest power, or -1
+    int count;          // non-zero coefficients
+};
+
+/**----------------------------------------------------------------------------
+ * Stores a 32-bit number, lowest byte first.
+ * @param value  The number to store.
+ * @param out  The array to receive it.
+ * @pre out has room for 4 bytes.
+ * @post out holds the number.
+ */
+void putWord(unsigned int value, char *out);
+
+/**----------------------------------------------------------------------------
+ * Loads a 32-bit number stored lowest byte first.
+ * @param in  The stored number.
+ * @pre in has 4 bytes.
+ * @post None.
+ * @return The number.
+ */
+unsigned int getWord(const char *in);
+
+/**----------------------------------------------------------------------------
+ * Encodes a header.
+ * @param header  The fields to encode.
+ * @param out  The array to receive the header.
+ * @pre out has room for SERIAL_HEADER_SIZE bytes.
+ * @post out holds the header, with the magic and SERIAL_VERSION.
+ */
+void writeHeader(const SerialHeader& header, char *out);
+
+/**----------------------------------------------------------------------------
+ * Decodes and checks a header.
+ * @param in  The encoded header.
+ * @param header  The fields to receive the header.
+ * @pre in has SERIAL_HEADER_SIZE bytes.
+ * @post header holds the fields if they are valid.
+ * @return true if the magic and version match, the degree is below INT_MAX
+ *         and the form, width, degree and count are consistent; false,
+ *         otherwise.
+ */
+bool readHeader(const char *in, SerialHeader& header);
+
+/**----------------------------------------------------------------------------
+ * Checks whether a body can be used as a coefficient list where it lies.
+ * @param header  The header of the body.
+ * @pre None.
+ * @post None.
+ * @return true if the body is dense, 4 bytes per coefficient and this
+ *         machine is little-endian; false, otherwise.
+ */
+bool isNative(const SerialHeader& header);
+
+/**----------------------------------------------------------------------------
+ * Finds the narrowest width that holds every element of an array.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @pre None.
+ * @post None.
+ * @return 1, 2 or 4.
+ */
+int coeffWidth(const int *coeffs, int n);
+
+/**----------------------------------------------------------------------------
+ * Encodes coefficients as little-endian signed integers of a width.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param width  The width; 1, 2 or 4.
+ * @param out  The array to receive the encoding.
+ * @pre Every element fits in width bytes. out has room for n * width bytes.
+ * @post out holds the encoding.
+ */
+void packCoeffs(const int *coeffs, int n, int width, char *out);
+
+/**----------------------------------------------------------------------------
+ * Decodes coefficients stored as little-endian signed integers of a width.
+ * @param in  The encoding.
+ * @param n  The number of coefficients.
+ * @param width  The width; 1, 2 or 4.
+ * @param out  The array to receive the coefficients.
+ * @pre in has n * width bytes. out has room for n elements. in is either
+ *      apart from out or the last n * width bytes of it, so that a body read
+ *      into the end of a coefficient list can be widened where it lies.
+ * @post out holds the coefficients.
+ */
+void unpackCoeffs(const char *in, int n, int width, int *out);
+
+/**----------------------------------------------------------------------------
+ * Encodes a number as a varint.
+ * @param value  The number to encode.
+ * @param out  The array to receive the encoding.
+ * @pre out has room for 5 bytes.
+ * @post out holds the encoding.
+ * @return One past the last byte written.
+ */
+char *putVarint(unsigned int value, char *out);
+
+/**----------------------------------------------------------------------------
+ * Decodes a varint.
+ * @param in  The first byte of the encoding.
+ * @param end  One past the last byte that may be read.
+ * @param value  The number to receive the value.
+ * @pre in is no greater than end.
+ * @post value holds the number if the encoding was valid.
+ * @return One past the last byte of the encoding, or NULL if it ran past end
+ *         or was longer than 5 bytes.
+ */
+const char *getVarint(const char *in, const char *end, unsigned int& value);
+
+#endif	/* _POLYSERIAL_H */
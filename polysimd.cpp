@@ -0,0 +1,934 @@
+/**
+ * @file    polysimd.cpp
+ * @brief   Elementwise kernels for the coefficient arrays behind Poly: adding
+ *          one array into another, subtracting it, adding a multiple of it,
+ *          and evaluating one at one or many points. Each kernel has
+ *          AVX-512, AVX2 and SSE4 versions that work on 16, 8 and 4
+ *          coefficients at a time, and a portable loop; the
+ *          widest one the CPU supports is picked at run time (see
+ *          cpudispatch.h). Arithmetic wraps around on overflow, exactly as
+ *          the scalar loops in Poly do. On long arrays the vector versions
+ *          run as fast as memory can supply the operands.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "polysimd.h"
+#include "cpudispatch.h"
+
+// the vector kernels need x86 intrinsics and per-function target attributes,
+// so that each is built whatever the rest of the program is compiled for
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define	POLYSIMD_X86
+#include <immintrin.h>
+#endif
+
+/**----------------------------------------------------------------------------
+ * Portable kernels. Unsigned arithmetic is used so that overflow wraps around
+ * with well-defined results.
+ * @param dst  The array to add to or subtract from.
+ * @param src  The array to add or subtract.
+ * @param factor  The multiple of src to add (scaleAddPortable only).
+ * @param n  The number of elements.
+ * @pre dst and src have at least n elements.
+ * @post dst has changed by src, -src or factor * src.
+ */
+static void addPortable(int *dst, const int *src, int n)
+{
+    unsigned int *out = reinterpret_cast<unsigned int*>(dst);
+    const unsigned int *in = reinterpret_cast<const unsigned int*>(src);
+
+    for (int i = 0; i < n; ++i)
+    {
+        out[i] += in[i];
+    } // end for (int i = 0)
+} // end addPortable(int*, const int*, int)
+
+static void subPortable(int *dst, const int *src, int n)
+{
+    unsigned int *out = reinterpret_cast<unsigned int*>(dst);
+    const unsigned int *in = reinterpret_cast<const unsigned int*>(src);
+
+    for (int i = 0; i < n; ++i)
+    {
+        out[i] -= in[i];
+    } // end for (int i = 0)
+} // end subPortable(int*, const int*, int)
+
+static void scaleAddPortable(int *dst, const int *src, int factor, int n)
+{
+    unsigned int *out = reinterpret_cast<unsigned int*>(dst);
+    const unsigned int *in = reinterpret_cast<const unsigned int*>(src);
+    unsigned int scale = static_cast<unsigned int>(factor);
+
+    for (int i = 0; i < n; ++i)
+    {
+        out[i] += scale * in[i];
+    } // end for (int i = 0)
+} // end scaleAddPortable(int*, const int*, int, int)
+
+// points each Horner kernel evaluates together in the portable loop, and
+// vectors of points in the vector kernels; each step of a point waits on a
+// multiply, so several independent ones keep the multiplier busy
+static const int HORNER_LANES = 4;
+
+/**----------------------------------------------------------------------------
+ * Portable Horner kernel. Points are evaluated HORNER_LANES at a time.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements.
+ * @post out[j] holds the value at points[j].
+ */
+static void hornerPortable(const int *coeffs, int n, const int *points,
+                           int count, int *out)
+{
+    const unsigned int *c = reinterpret_cast<const unsigned int*>(coeffs);
+    const unsigned int *x = reinterpret_cast<const unsigned int*>(points);
+
+    for (int j = 0; j < count; j += HORNER_LANES)
+    {
+        int lanes = count - j < HORNER_LANES ? count - j : HORNER_LANES;
+        unsigned int acc[HORNER_LANES];
+
+        for (int k = 0; k < lanes; ++k)
+        {
+            acc[k] = c[n - 1];
+        } // end for (int k = 0)
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            for (int k = 0; k < lanes; ++k)
+            {
+                acc[k] = acc[k] * x[j + k] + c[i];
+            } // end for (int k = 0)
+        } // end for (int i = n - 2)
+
+        for (int k = 0; k < lanes; ++k)
+        {
+            out[j + k] = static_cast<int>(acc[k]);
+        } // end for (int k = 0)
+    } // end for (int j = 0)
+} // end hornerPortable(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Raises a number to a power of 2 by repeated squaring.
+ * @param x  The number to raise.
+ * @param power  The power; a power of 2.
+ * @pre None.
+ * @post None.
+ * @return x^power, wrapped around to 32 bits.
+ */
+static unsigned int powerOfTwo(int x, int power)
+{
+    unsigned int result = static_cast<unsigned int>(x);
+
+    for (; power > 1; power /= 2)
+    {
+        result *= result;
+    } // end for (; power > 1)
+
+    return result;
+} // end powerOfTwo(int, int)
+
+/**----------------------------------------------------------------------------
+ * Joins the values of interleaved Horner chains with Estrin's scheme. Chain
+ * k holds the coefficients k, k + count, k + 2count, ..., so the value at x
+ * is the sum of chain k times x^k. Pairs of chains are joined with x, pairs
+ * of pairs with x^2 and so on; each round is count / 2 independent
+ * multiplications rather than one chain of count.
+ * @param lanes  The values of the chains; overwritten.
+ * @param count  The number of chains; a power of 2.
+ * @param x  The point being evaluated at.
+ * @pre count is greater than 0.
+ * @post lanes[0] holds the result; the other elements are undefined.
+ * @return The sum of lanes[k] * x^k, wrapped around to 32 bits.
+ */
+static unsigned int joinLanes(unsigned int *lanes, int count, int x)
+{
+    unsigned int power = static_cast<unsigned int>(x);
+
+    for (; count > 1; count /= 2, power *= power)
+    {
+        for (int k = 0; k < count / 2; ++k)
+        {
+            lanes[k] = lanes[2 * k] + lanes[2 * k + 1] * power;
+        } // end for (int k = 0)
+    } // end for (; count > 1)
+
+    return lanes[0];
+} // end joinLanes(unsigned int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * Finishes an evaluation with the coefficients below the ones the chains
+ * covered, by Horner's rule starting from the chains' joined value.
+ * @param coeffs  The coefficients.
+ * @param low  The number of coefficients below the chains.
+ * @param x  The point being evaluated at.
+ * @param upper  The value of the coefficients from low up, divided by
+ *               x^low.
+ * @pre None.
+ * @post None.
+ * @return upper * x^low plus the value of the low coefficients.
+ */
+static unsigned int hornerLow(const int *coeffs, int low, int x,
+                              unsigned int upper)
+{
+    unsigned int point = static_cast<unsigned int>(x);
+
+    for (int i = low - 1; i >= 0; --i)
+    {
+        upper = upper * point + static_cast<unsigned int>(coeffs[i]);
+    } // end for (int i = low - 1)
+
+    return upper;
+} // end hornerLow(const int*, int, int, unsigned int)
+
+/**----------------------------------------------------------------------------
+ * Portable single-point kernel. The coefficients from the top down are
+ * split into HORNER_LANES interleaved chains, each evaluated with Horner's
+ * rule in x^HORNER_LANES so that their multiplications overlap, and the
+ * chains are joined with joinLanes(). The few coefficients below a whole
+ * number of rows finish the evaluation.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param x  The point to evaluate at.
+ * @pre n is greater than 0.
+ * @post None.
+ * @return The value at x.
+ */
+static int evalPortable(const int *coeffs, int n, int x)
+{
+    const int width = HORNER_LANES;
+    int low = n % width;
+
+    if (n < width)
+    {
+        return static_cast<int>(hornerLow(coeffs, n, x, 0));
+    } // end if (n < width)
+
+    const unsigned int *block = reinterpret_cast<const unsigned int*>(
+            coeffs + low);
+    int top = n - low - width;
+    unsigned int step = powerOfTwo(x, width);
+    unsigned int lanes[HORNER_LANES];
+
+    for (int k = 0; k < width; ++k)
+    {
+        lanes[k] = block[top + k];
+    } // end for (int k = 0)
+
+    for (int b = top - width; b >= 0; b -= width)
+    {
+        for (int k = 0; k < width; ++k)
+        {
+            lanes[k] = lanes[k] * step + block[b + k];
+        } // end for (int k = 0)
+    } // end for (int b = top - width)
+
+    return static_cast<int>(hornerLow(coeffs, low, x,
+                                      joinLanes(lanes, width, x)));
+} // end evalPortable(const int*, int, int)
+
+#ifdef POLYSIMD_X86
+
+/**----------------------------------------------------------------------------
+ * SSE4 kernels, 4 coefficients per instruction. Lanes are added and
+ * multiplied modulo 2^32, which is the wraparound of the portable loops.
+ * Elements left over at the end go through the portable kernels.
+ * @param dst  The array to add to or subtract from.
+ * @param src  The array to add or subtract.
+ * @param factor  The multiple of src to add (scaleAddSse4 only).
+ * @param n  The number of elements.
+ * @pre dst and src have at least n elements. The CPU supports SSE4.1.
+ * @post dst has changed by src, -src or factor * src.
+ */
+__attribute__((target("sse4.1")))
+static void addSse4(int *dst, const int *src, int n)
+{
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_add_epi32(a, b));
+    } // end for (; i + 4 <= n)
+
+    addPortable(dst + i, src + i, n - i);
+} // end addSse4(int*, const int*, int)
+
+__attribute__((target("sse4.1")))
+static void subSse4(int *dst, const int *src, int n)
+{
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_sub_epi32(a, b));
+    } // end for (; i + 4 <= n)
+
+    subPortable(dst + i, src + i, n - i);
+} // end subSse4(int*, const int*, int)
+
+__attribute__((target("sse4.1")))
+static void scaleAddSse4(int *dst, const int *src, int factor, int n)
+{
+    __m128i scale = _mm_set1_epi32(factor);
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_add_epi32(a, _mm_mullo_epi32(b, scale)));
+    } // end for (; i + 4 <= n)
+
+    scaleAddPortable(dst + i, src + i, factor, n - i);
+} // end scaleAddSse4(int*, const int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * SSE4 Horner kernel: HORNER_LANES vectors of 4 points at a time, then one
+ * vector at a time; points left over go through the portable kernel.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements. The
+ *      CPU supports SSE4.1.
+ * @post out[j] holds the value at points[j].
+ */
+__attribute__((target("sse4.1")))
+static void hornerSse4(const int *coeffs, int n, const int *points,
+                       int count, int *out)
+{
+    int j = 0;
+
+    for (; j + 4 * HORNER_LANES <= count; j += 4 * HORNER_LANES)
+    {
+        __m128i x[HORNER_LANES], acc[HORNER_LANES];
+
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            x[k] = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(points + j + 4 * k));
+            acc[k] = _mm_set1_epi32(coeffs[n - 1]);
+        } // end for (int k = 0)
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            __m128i c = _mm_set1_epi32(coeffs[i]);
+
+            for (int k = 0; k < HORNER_LANES; ++k)
+            {
+                acc[k] = _mm_add_epi32(_mm_mullo_epi32(acc[k], x[k]), c);
+            } // end for (int k = 0)
+        } // end for (int i = n - 2)
+
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j + 4 * k),
+                             acc[k]);
+        } // end for (int k = 0)
+    } // end for (; j + 4 * HORNER_LANES <= count)
+
+    for (; j + 4 <= count; j += 4)
+    {
+        __m128i x = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(points + j));
+        __m128i acc = _mm_set1_epi32(coeffs[n - 1]);
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            acc = _mm_add_epi32(_mm_mullo_epi32(acc, x),
+                                _mm_set1_epi32(coeffs[i]));
+        } // end for (int i = n - 2)
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + j), acc);
+    } // end for (; j + 4 <= count)
+
+    hornerPortable(coeffs, n, points + j, count - j, out + j);
+} // end hornerSse4(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * SSE4 single-point kernel: HORNER_LANES vectors of 4 lanes, so 16 chains
+ * in x^16; otherwise as the portable kernel.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param x  The point to evaluate at.
+ * @pre n is greater than 0. The CPU supports SSE4.1.
+ * @post None.
+ * @return The value at x.
+ */
+__attribute__((target("sse4.1")))
+static int evalSse4(const int *coeffs, int n, int x)
+{
+    const int width = 4 * HORNER_LANES;
+    int low = n % width;
+
+    if (n < width)
+    {
+        return static_cast<int>(hornerLow(coeffs, n, x, 0));
+    } // end if (n < width)
+
+    const int *block = coeffs + low;
+    int top = n - low - width;
+    int power = static_cast<int>(powerOfTwo(x, width));
+    __m128i step = _mm_set1_epi32(power);
+    __m128i acc[HORNER_LANES];
+
+    for (int k = 0; k < HORNER_LANES; ++k)
+    {
+        acc[k] = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(block + top + 4 * k));
+    } // end for (int k = 0)
+
+    for (int b = top - width; b >= 0; b -= width)
+    {
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            __m128i c = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(block + b + 4 * k));
+
+            acc[k] = _mm_add_epi32(_mm_mullo_epi32(acc[k], step), c);
+        } // end for (int k = 0)
+    } // end for (int b = top - width)
+
+    unsigned int lanes[4 * HORNER_LANES];
+
+    for (int k = 0; k < HORNER_LANES; ++k)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 4 * k), acc[k]);
+    } // end for (int k = 0)
+
+    return static_cast<int>(hornerLow(coeffs, low, x,
+                                      joinLanes(lanes, width, x)));
+} // end evalSse4(const int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * AVX2 kernels, 8 coefficients per instruction; otherwise as the SSE4
+ * kernels.
+ * @param dst  The array to add to or subtract from.
+ * @param src  The array to add or subtract.
+ * @param factor  The multiple of src to add (scaleAddAvx2 only).
+ * @param n  The number of elements.
+ * @pre dst and src have at least n elements. The CPU supports AVX2.
+ * @post dst has changed by src, -src or factor * src.
+ */
+__attribute__((target("avx2")))
+static void addAvx2(int *dst, const int *src, int n)
+{
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i a = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(src + i));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_add_epi32(a, b));
+    } // end for (; i + 8 <= n)
+
+    addPortable(dst + i, src + i, n - i);
+} // end addAvx2(int*, const int*, int)
+
+__attribute__((target("avx2")))
+static void subAvx2(int *dst, const int *src, int n)
+{
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i a = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(src + i));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_sub_epi32(a, b));
+    } // end for (; i + 8 <= n)
+
+    subPortable(dst + i, src + i, n - i);
+} // end subAvx2(int*, const int*, int)
+
+__attribute__((target("avx2")))
+static void scaleAddAvx2(int *dst, const int *src, int factor, int n)
+{
+    __m256i scale = _mm256_set1_epi32(factor);
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i a = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(src + i));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_add_epi32(a, _mm256_mullo_epi32(b, scale)));
+    } // end for (; i + 8 <= n)
+
+    scaleAddPortable(dst + i, src + i, factor, n - i);
+} // end scaleAddAvx2(int*, const int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * AVX2 Horner kernel: HORNER_LANES vectors of 8 points at a time, then one
+ * vector at a time; otherwise as the SSE4 kernel.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements. The
+ *      CPU supports AVX2.
+ * @post out[j] holds the value at points[j].
+ */
+__attribute__((target("avx2")))
+static void hornerAvx2(const int *coeffs, int n, const int *points,
+                       int count, int *out)
+{
+    int j = 0;
+
+    for (; j + 8 * HORNER_LANES <= count; j += 8 * HORNER_LANES)
+    {
+        __m256i x[HORNER_LANES], acc[HORNER_LANES];
+
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            x[k] = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(points + j + 8 * k));
+            acc[k] = _mm256_set1_epi32(coeffs[n - 1]);
+        } // end for (int k = 0)
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            __m256i c = _mm256_set1_epi32(coeffs[i]);
+
+            for (int k = 0; k < HORNER_LANES; ++k)
+            {
+                acc[k] = _mm256_add_epi32(_mm256_mullo_epi32(acc[k], x[k]),
+                                          c);
+            } // end for (int k = 0)
+        } // end for (int i = n - 2)
+
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j + 8 * k),
+                                acc[k]);
+        } // end for (int k = 0)
+    } // end for (; j + 8 * HORNER_LANES <= count)
+
+    for (; j + 8 <= count; j += 8)
+    {
+        __m256i x = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(points + j));
+        __m256i acc = _mm256_set1_epi32(coeffs[n - 1]);
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            acc = _mm256_add_epi32(_mm256_mullo_epi32(acc, x),
+                                   _mm256_set1_epi32(coeffs[i]));
+        } // end for (int i = n - 2)
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), acc);
+    } // end for (; j + 8 <= count)
+
+    hornerPortable(coeffs, n, points + j, count - j, out + j);
+} // end hornerAvx2(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * AVX2 single-point kernel: HORNER_LANES vectors of 8 lanes, so 32 chains
+ * in x^32; otherwise as the portable kernel.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param x  The point to evaluate at.
+ * @pre n is greater than 0. The CPU supports AVX2.
+ * @post None.
+ * @return The value at x.
+ */
+__attribute__((target("avx2")))
+static int evalAvx2(const int *coeffs, int n, int x)
+{
+    const int width = 8 * HORNER_LANES;
+    int low = n % width;
+
+    if (n < width)
+    {
+        return static_cast<int>(hornerLow(coeffs, n, x, 0));
+    } // end if (n < width)
+
+    const int *block = coeffs + low;
+    int top = n - low - width;
+    int power = static_cast<int>(powerOfTwo(x, width));
+    __m256i step = _mm256_set1_epi32(power);
+    __m256i acc[HORNER_LANES];
+
+    for (int k = 0; k < HORNER_LANES; ++k)
+    {
+        acc[k] = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(block + top + 8 * k));
+    } // end for (int k = 0)
+
+    for (int b = top - width; b >= 0; b -= width)
+    {
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            __m256i c = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(block + b + 8 * k));
+
+            acc[k] = _mm256_add_epi32(_mm256_mullo_epi32(acc[k], step), c);
+        } // end for (int k = 0)
+    } // end for (int b = top - width)
+
+    unsigned int lanes[8 * HORNER_LANES];
+
+    for (int k = 0; k < HORNER_LANES; ++k)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 8 * k), acc[k]);
+    } // end for (int k = 0)
+
+    return static_cast<int>(hornerLow(coeffs, low, x,
+                                      joinLanes(lanes, width, x)));
+} // end evalAvx2(const int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * AVX-512 kernels, 16 coefficients per instruction. Elements left over at
+ * the end are handled with one masked load and store instead of the portable
+ * kernels.
+ * @param dst  The array to add to or subtract from.
+ * @param src  The array to add or subtract.
+ * @param factor  The multiple of src to add (scaleAddAvx512 only).
+ * @param n  The number of elements.
+ * @pre dst and src have at least n elements. The CPU supports AVX-512F.
+ * @post dst has changed by src, -src or factor * src.
+ */
+__attribute__((target("avx512f")))
+static void addAvx512(int *dst, const int *src, int n)
+{
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i a = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(dst + i));
+        __m512i b = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(src + i));
+
+        _mm512_storeu_si512(reinterpret_cast<__m512i*>(dst + i),
+                            _mm512_add_epi32(a, b));
+    } // end for (; i + 16 <= n)
+
+    if (i < n)
+    {
+        __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512i a = _mm512_maskz_loadu_epi32(tail, dst + i);
+        __m512i b = _mm512_maskz_loadu_epi32(tail, src + i);
+
+        _mm512_mask_storeu_epi32(dst + i, tail, _mm512_add_epi32(a, b));
+    } // end if (i < n)
+} // end addAvx512(int*, const int*, int)
+
+__attribute__((target("avx512f")))
+static void subAvx512(int *dst, const int *src, int n)
+{
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i a = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(dst + i));
+        __m512i b = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(src + i));
+
+        _mm512_storeu_si512(reinterpret_cast<__m512i*>(dst + i),
+                            _mm512_sub_epi32(a, b));
+    } // end for (; i + 16 <= n)
+
+    if (i < n)
+    {
+        __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512i a = _mm512_maskz_loadu_epi32(tail, dst + i);
+        __m512i b = _mm512_maskz_loadu_epi32(tail, src + i);
+
+        _mm512_mask_storeu_epi32(dst + i, tail, _mm512_sub_epi32(a, b));
+    } // end if (i < n)
+} // end subAvx512(int*, const int*, int)
+
+__attribute__((target("avx512f")))
+static void scaleAddAvx512(int *dst, const int *src, int factor, int n)
+{
+    __m512i scale = _mm512_set1_epi32(factor);
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i a = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(dst + i));
+        __m512i b = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(src + i));
+
+        _mm512_storeu_si512(reinterpret_cast<__m512i*>(dst + i),
+                            _mm512_add_epi32(a, _mm512_mullo_epi32(b, scale)));
+    } // end for (; i + 16 <= n)
+
+    if (i < n)
+    {
+        __mmask16 tail = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512i a = _mm512_maskz_loadu_epi32(tail, dst + i);
+        __m512i b = _mm512_maskz_loadu_epi32(tail, src + i);
+        __m512i sum = _mm512_add_epi32(a, _mm512_mullo_epi32(b, scale));
+
+        _mm512_mask_storeu_epi32(dst + i, tail, sum);
+    } // end if (i < n)
+} // end scaleAddAvx512(int*, const int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * AVX-512 Horner kernel: HORNER_LANES vectors of 16 points at a time, then
+ * one vector at a time, with a masked load and store for the points left
+ * over.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements. The
+ *      CPU supports AVX-512F.
+ * @post out[j] holds the value at points[j].
+ */
+__attribute__((target("avx512f")))
+static void hornerAvx512(const int *coeffs, int n, const int *points,
+                         int count, int *out)
+{
+    int j = 0;
+
+    for (; j + 16 * HORNER_LANES <= count; j += 16 * HORNER_LANES)
+    {
+        __m512i x[HORNER_LANES], acc[HORNER_LANES];
+
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            x[k] = _mm512_loadu_si512(
+                    reinterpret_cast<const __m512i*>(points + j + 16 * k));
+            acc[k] = _mm512_set1_epi32(coeffs[n - 1]);
+        } // end for (int k = 0)
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            __m512i c = _mm512_set1_epi32(coeffs[i]);
+
+            for (int k = 0; k < HORNER_LANES; ++k)
+            {
+                acc[k] = _mm512_add_epi32(_mm512_mullo_epi32(acc[k], x[k]),
+                                          c);
+            } // end for (int k = 0)
+        } // end for (int i = n - 2)
+
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            _mm512_storeu_si512(reinterpret_cast<__m512i*>(out + j + 16 * k),
+                                acc[k]);
+        } // end for (int k = 0)
+    } // end for (; j + 16 * HORNER_LANES <= count)
+
+    for (; j < count; j += 16)
+    {
+        int lanes = count - j < 16 ? count - j : 16;
+        __mmask16 mask = static_cast<__mmask16>((1u << lanes) - 1);
+        __m512i x = _mm512_maskz_loadu_epi32(mask, points + j);
+        __m512i acc = _mm512_set1_epi32(coeffs[n - 1]);
+
+        for (int i = n - 2; i >= 0; --i)
+        {
+            acc = _mm512_add_epi32(_mm512_mullo_epi32(acc, x),
+                                   _mm512_set1_epi32(coeffs[i]));
+        } // end for (int i = n - 2)
+
+        _mm512_mask_storeu_epi32(out + j, mask, acc);
+    } // end for (; j < count)
+} // end hornerAvx512(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * AVX-512 single-point kernel: HORNER_LANES vectors of 16 lanes, so 64
+ * chains in x^64; otherwise as the portable kernel.
+ * @param coeffs  The coefficients.
+ * @param n  The number of elements in coeffs.
+ * @param x  The point to evaluate at.
+ * @pre n is greater than 0. The CPU supports AVX-512F.
+ * @post None.
+ * @return The value at x.
+ */
+__attribute__((target("avx512f")))
+static int evalAvx512(const int *coeffs, int n, int x)
+{
+    const int width = 16 * HORNER_LANES;
+    int low = n % width;
+
+    if (n < width)
+    {
+        return static_cast<int>(hornerLow(coeffs, n, x, 0));
+    } // end if (n < width)
+
+    const int *block = coeffs + low;
+    int top = n - low - width;
+    int power = static_cast<int>(powerOfTwo(x, width));
+    __m512i step = _mm512_set1_epi32(power);
+    __m512i acc[HORNER_LANES];
+
+    for (int k = 0; k < HORNER_LANES; ++k)
+    {
+        acc[k] = _mm512_loadu_si512(
+                reinterpret_cast<const __m512i*>(block + top + 16 * k));
+    } // end for (int k = 0)
+
+    for (int b = top - width; b >= 0; b -= width)
+    {
+        for (int k = 0; k < HORNER_LANES; ++k)
+        {
+            __m512i c = _mm512_loadu_si512(
+                    reinterpret_cast<const __m512i*>(block + b + 16 * k));
+
+            acc[k] = _mm512_add_epi32(_mm512_mullo_epi32(acc[k], step), c);
+        } // end for (int k = 0)
+    } // end for (int b = top - width)
+
+    unsigned int lanes[16 * HORNER_LANES];
+
+    for (int k = 0; k < HORNER_LANES; ++k)
+    {
+        _mm512_storeu_si512(reinterpret_cast<__m512i*>(lanes + 16 * k),
+                            acc[k]);
+    } // end for (int k = 0)
+
+    return static_cast<int>(hornerLow(coeffs, low, x,
+                                      joinLanes(lanes, width, x)));
+} // end evalAvx512(const int*, int, int)
+
+#endif	/* POLYSIMD_X86 */
+
+// one set of kernels for each instruction set
+struct CoeffKernels
+{
+    void (*add)(int *dst, const int *src, int n);
+    void (*sub)(int *dst, const int *src, int n);
+    void (*scaleAdd)(int *dst, const int *src, int factor, int n);
+    void (*horner)(const int *coeffs, int n, const int *points, int count,
+                   int *out);
+    int (*evaluate)(const int *coeffs, int n, int x);
+};
+
+// indexed by SimdLevel
+static const CoeffKernels KERNELS[] =
+{
+    { addPortable, subPortable, scaleAddPortable, hornerPortable,
+      evalPortable },
+#ifdef POLYSIMD_X86
+    { addSse4, subSse4, scaleAddSse4, hornerSse4,
+      evalSse4 },
+    { addAvx2, subAvx2, scaleAddAvx2, hornerAvx2,
+      evalAvx2 },
+    { addAvx512, subAvx512, scaleAddAvx512, hornerAvx512,
+      evalAvx512 }
+#else
+    { addPortable, subPortable, scaleAddPortable, hornerPortable,
+      evalPortable },
+    { addPortable, subPortable, scaleAddPortable, hornerPortable,
+      evalPortable },
+    { addPortable, subPortable, scaleAddPortable, hornerPortable,
+      evalPortable }
+#endif
+};
+
+/**----------------------------------------------------------------------------
+ * Adds one coefficient array into another.
+ * @param dst  The array to add to.
+ * @param src  The array to add. May be dst.
+ * @param n  The number of elements to add.
+ * @pre dst and src have at least n elements, and either are the same array or
+ *      do not overlap.
+ * @post dst[i] has increased by src[i] for each i below n.
+ */
+void addCoeffs(int *dst, const int *src, int n)
+{
+    KERNELS[getSimdLevel()].add(dst, src, n);
+} // end addCoeffs(int*, const int*, int)
+
+/**----------------------------------------------------------------------------
+ * Subtracts one coefficient array from another.
+ * @param dst  The array to subtract from.
+ * @param src  The array to subtract. May be dst.
+ * @param n  The number of elements to subtract.
+ * @pre dst and src have at least n elements, and either are the same array or
+ *      do not overlap.
+ * @post dst[i] has decreased by src[i] for each i below n.
+ */
+void subCoeffs(int *dst, const int *src, int n)
+{
+    KERNELS[getSimdLevel()].sub(dst, src, n);
+} // end subCoeffs(int*, const int*, int)
+
+/**----------------------------------------------------------------------------
+ * Adds a multiple of one coefficient array into another.
+ * @param dst  The array to add to.
+ * @param src  The array whose multiple is added. May be dst.
+ * @param factor  The multiple of src to add.
+ * @param n  The number of elements to add.
+ * @pre dst and src have at least n elements, and either are the same array or
+ *      do not overlap.
+ * @post dst[i] has increased by factor * src[i] for each i below n.
+ */
+void scaleAddCoeffs(int *dst, const int *src, int factor, int n)
+{
+    KERNELS[getSimdLevel()].scaleAdd(dst, src, factor, n);
+} // end scaleAddCoeffs(int*, const int*, int, int)
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at several points with Horner's rule, one
+ * point per vector lane, so that a vector of points advances through the
+ * coefficients together.
+ * @param coeffs  The coefficients, where the index of an element is its
+ *                power.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements.
+ * @post out[j] holds the value at points[j], wrapped around to 32 bits, for
+ *       each j below count.
+ */
+void hornerCoeffs(const int *coeffs, int n, const int *points, int count,
+                  int *out)
+{
+    KERNELS[getSimdLevel()].horner(coeffs, n, points, count, out);
+} // end hornerCoeffs(const int*, int, const int*, int, int*)
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at one point. The coefficients are split
+ * into interleaved chains, one per vector lane, each evaluated with Horner's
+ * rule in a power of x so that the lanes advance together; the chains are
+ * then joined with Estrin's scheme. That removes the serial dependence of
+ * plain Horner's rule, where each step waits on the last multiplication.
+ * @param coeffs  The coefficients, where the index of an element is its
+ *                power.
+ * @param n  The number of elements in coeffs.
+ * @param x  The point to evaluate at.
+ * @pre n is greater than 0.
+ * @post None.
+ * @return The value at x, wrapped around to 32 bits.
+ */
+int evalCoeffs(const int *coeffs, int n, int x)
+{
+    return KERNELS[getSimdLevel()].evaluate(coeffs, n, x);
+} // end evalCoeffs(const int*, int, int)
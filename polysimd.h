@@ -0,0 +1,86 @@
+/**
+ * @file    polysimd.h
+ * @brief   Elementwise kernels for the coefficient arrays behind Poly: adding
+ *          one array into another, subtracting it, adding a multiple of it,
+ *          and evaluating one at one or many points. Each kernel has
+ *          AVX-512, AVX2 and SSE4 versions that work on 16, 8 and 4
+ *          coefficients at a time, and a portable loop; the
+ *          widest one the CPU supports is picked at run time (see
+ *          cpudispatch.h). Arithmetic wraps around on overflow, exactly as
+ *          the scalar loops in Poly do. On long arrays the vector versions
+ *          run as fast as memory can supply the operands.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _POLYSIMD_H
+#define	_POLYSIMD_H
+
+/**----------------------------------------------------------------------------
+ * Adds one coefficient array into another.
+ * @param dst  The array to add to.
+ * @param src  The array to add. May be dst.
+ * @param n  The number of elements to add.
+ * @pre dst and src have at least n elements, and either are the same array
+ *      or do not overlap.
+ * @post dst[i] has increased by src[i] for each i below n.
+ */
+void addCoeffs(int *dst, const int *src, int n);
+
+/**----------------------------------------------------------------------------
+ * Subtracts one coefficient array from another.
+ * @param dst  The array to subtract from.
+ * @param src  The array to subtract. May be dst.
+ * @param n  The number of elements to subtract.
+ * @pre dst and src have at least n elements, and either are the same array
+ *      or do not overlap.
+ * @post dst[i] has decreased by src[i] for each i below n.
+ */
+void subCoeffs(int *dst, const int *src, int n);
+
+/**----------------------------------------------------------------------------
+ * Adds a multiple of one coefficient array into another.
+ * @param dst  The array to add to.
+ * @param src  The array whose multiple is added. May be dst.
+ * @param factor  The multiple of src to add.
+ * @param n  The number of elements to add.
+ * @pre dst and src have at least n elements, and either are the same array
+ *      or do not overlap.
+ * @post dst[i] has increased by factor * src[i] for each i below n.
+ */
+void scaleAddCoeffs(int *dst, const int *src, int factor, int n);
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at several points with Horner's rule, one
+ * point per vector lane, so that a vector of points advances through the
+ * coefficients together.
+ * @param coeffs  The coefficients, where the index of an element is its
+ *                power.
+ * @param n  The number of elements in coeffs.
+ * @param points  The points to evaluate at.
+ * @param count  The number of points.
+ * @param out  The array to receive the values.
+ * @pre n is greater than 0. points and out have at least count elements.
+ * @post out[j] holds the value at points[j], wrapped around to 32 bits, for
+ *       each j below count.
+ */
+void hornerCoeffs(const int *coeffs, int n, const int *points, int count,
+                  int *out);
+
+/**----------------------------------------------------------------------------
+ * Evaluates a coefficient array at one point. The coefficients are split
+ * into interleaved chains, one per vector lane, each evaluated with Horner's
+ * rule in a power of x so that the lanes advance together; the chains are
+ * then joined with Estrin's scheme. That removes the serial dependence of
+ * plain Horner's rule, where each step waits on the last multiplication.
+ * @param coeffs  The coefficients, where the index of an element is its
+ *                power.
+ * @param n  The number of elements in coeffs.
+ * @param x  The point to evaluate at.
+ * @pre n is greater than 0.
+ * @post None.
+ * @return The value at x, wrapped around to 32 bits.
+ */
+int evalCoeffs(const int *coeffs, int n, int x);
+
+#endif	/* _POLYSIMD_H */
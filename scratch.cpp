@@ -0,0 +1,108 @@
+/**
+ * @file    scratch.cpp
+ * @brief   Temporary storage for the arithmetic kernels behind Poly. A
+ *          ScratchBuffer takes its elements from an arena that belongs to the
+ *          calling thread and gives them back when it goes out of scope, so
+ *          buffers must be released in the reverse order they were taken,
+ *          as local variables are. A request that does not fit in the arena
+ *          is served from the heap instead, and the arena grows to the
+ *          largest total demand it has seen the next time it is empty. Once
+ *          a workload has run through once, repeating it takes no further
+ *          allocations.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "scratch.h"
+#include <cstddef>
+
+// one bump-allocated block per thread, released when the thread ends
+struct Arena
+{
+    unsigned int *base;
+    int used;       // elements handed out from base
+    int capacity;   // elements in base
+    int demand;     // elements held by live buffers, wherever they came from
+    int peak;       // largest demand since base was last allocated
+
+    Arena() : base(NULL), used(0), capacity(0), demand(0), peak(0)
+    {
+    } // end Default Constructor
+
+    ~Arena()
+    {
+        delete [] base;
+        base = NULL;
+    } // end Destructor
+};
+
+static thread_local Arena arena;
+
+/**----------------------------------------------------------------------------
+ * Constructor. Takes a number of elements from the arena of the calling
+ * thread, or from the heap if the arena is too full.
+ * @param count  The number of elements needed; not negative.
+ * @pre None.
+ * @post data() points at count elements of uninitialized storage.
+ */
+ScratchBuffer::ScratchBuffer(int count) : count(count)
+{
+    if (count <= arena.capacity - arena.used)
+    {
+        list = arena.base + arena.used;
+        owned = false;
+        arena.used += count;
+    }
+    else
+    {
+        list = new unsigned int[count > 0 ? count : 1];
+        owned = true;
+    } // end if (count <= arena.capacity - arena.used)
+
+    arena.demand += count;
+
+    if (arena.demand > arena.peak)
+    {
+        arena.peak = arena.demand;
+    } // end if (arena.demand > arena.peak)
+} // end Constructor
+
+/**----------------------------------------------------------------------------
+ * Destructor. Gives the elements back.
+ * @pre Every ScratchBuffer the calling thread created after this one has been
+ *      destroyed.
+ * @post The elements may be handed out again.
+ */
+ScratchBuffer::~ScratchBuffer()
+{
+    if (owned)
+    {
+        delete [] list;
+    }
+    else
+    {
+        arena.used -= count;
+    } // end if (owned)
+
+    list = NULL;
+    arena.demand -= count;
+
+    // grow once nothing is handed out, so the whole peak fits next time
+    if (arena.demand == 0 && arena.peak > arena.capacity)
+    {
+        delete [] arena.base;
+        arena.base = new unsigned int[arena.peak];
+        arena.capacity = arena.peak;
+    } // end if (arena.demand == 0 && ...)
+} // end Destructor
+
+/**----------------------------------------------------------------------------
+ * Accessor for the storage.
+ * @pre None.
+ * @post None.
+ * @return A pointer to the first element.
+ */
+unsigned int *ScratchBuffer::data() const
+{
+    return list;
+} // end data()
@@ -0,0 +1,59 @@
+/**
+ * @file    scratch.h
+ * @brief   Temporary storage for the arithmetic kernels behind Poly. A
+ *          ScratchBuffer takes its elements from an arena that belongs to the
+ *          calling thread and gives them back when it goes out of scope, so
+ *          buffers must be released in the reverse order they were taken,
+ *          as local variables are. A request that does not fit in the arena
+ *          is served from the heap instead, and the arena grows to the
+ *          largest total demand it has seen the next time it is empty. Once
+ *          a workload has run through once, repeating it takes no further
+ *          allocations.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _SCRATCH_H
+#define	_SCRATCH_H
+
+class ScratchBuffer
+{
+public:
+
+    /**------------------------------------------------------------------------
+     * Constructor. Takes a number of elements from the arena of the calling
+     * thread, or from the heap if the arena is too full.
+     * @param count  The number of elements needed; not negative.
+     * @pre None.
+     * @post data() points at count elements of uninitialized storage.
+     */
+    explicit ScratchBuffer(int count);
+
+    /**------------------------------------------------------------------------
+     * Destructor. Gives the elements back.
+     * @pre Every ScratchBuffer the calling thread created after this one has
+     *      been destroyed.
+     * @post The elements may be handed out again.
+     */
+    ~ScratchBuffer();
+
+    /**------------------------------------------------------------------------
+     * Accessor for the storage.
+     * @pre None.
+     * @post None.
+     * @return A pointer to the first element.
+     */
+    unsigned int *data() const;
+
+private:
+
+    // a buffer is tied to its place in the arena, so it cannot be copied
+    ScratchBuffer(const ScratchBuffer&);
+    ScratchBuffer& operator=(const ScratchBuffer&);
+
+    unsigned int *list;     // the storage handed out
+    int count;              // elements in list
+    bool owned;             // true if list came from the heap
+};
+
+#endif	/* _SCRATCH_H */
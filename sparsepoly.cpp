@@ -0,0 +1,530 @@
+/**
+ * @file    sparsepoly.cpp
+ * @brief   This class represents a polynomial as a list of terms, each an
+ *          exponent paired with a non-zero coefficient, kept in ascending
+ *          order of exponent. Unlike Poly, whose storage grows with its
+ *          largest power, a SparsePoly only stores the terms that are
+ *          present, so +50x^20000 +50 takes two terms instead of 20001
+ *          elements. Arithmetic, comparison and stream I/O all run in time
+ *          proportional to the number of terms. It offers the same interface
+ *          as Poly, including the same text format for iostreams, and can be
+ *          converted to and from a Poly.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "sparsepoly.h"
+#include "poly.h"
+#include "polyformat.h"
+#include "scratch.h"
+#include <algorithm>
+
+/**----------------------------------------------------------------------------
+ * Default constructor. Creates a SparsePoly with no terms, which represents 0.
+ * @pre None.
+ * @post SparsePoly has no terms.
+ */
+SparsePoly::SparsePoly()
+{
+} // end Default Constructor
+
+/**----------------------------------------------------------------------------
+ * Single parameter constructor. Creates a SparsePoly with an x^0 term of a
+ * specified coefficient.
+ * @param coeff  The coefficient of the x^0 term.
+ * @pre None.
+ * @post SparsePoly has a single x^0 term equal to coeff, or no terms if coeff
+ *       is 0.
+ */
+SparsePoly::SparsePoly(int coeff)
+{
+    setCoeff(coeff, 0);
+} // end 1 Parameter Constructor
+
+/**----------------------------------------------------------------------------
+ * Double parameter constructor. Creates a SparsePoly with a single term.
+ * @param coeff  The coefficient of the term.
+ * @param exp  The power of the term. Only the absolute value of exp is used.
+ * @pre None.
+ * @post SparsePoly has a single term coeff x^exp, or no terms if coeff is 0
+ *       or exp is above MAX_POWER.
+ */
+SparsePoly::SparsePoly(int coeff, int exp)
+{
+    setCoeff(coeff, exp);
+} // end 2 Parameter Constructor
+
+/**----------------------------------------------------------------------------
+ * Conversion constructor. Creates a SparsePoly holding the non-zero elements
+ * of a Poly.
+ * @param dense  The Poly to convert.
+ * @pre None.
+ * @post SparsePoly represents the same polynomial as dense.
+ */
+SparsePoly::SparsePoly(const Poly& dense)
+{
+    if (dense.sparse)
+    {
+        terms = dense.terms.terms;
+        return;
+    } // end if (dense.sparse)
+
+    for (int i = 0; i < dense.size; ++i)
+    {
+        if (dense.coeffList[i] != 0)
+        {
+            Term term = { i, dense.coeffList[i] };
+            terms.push_back(term);
+        } // end if (dense.coeffList[i] != 0)
+    } // end for (int i = 0)
+} // end Conversion Constructor
+
+/**----------------------------------------------------------------------------
+ * Converts this SparsePoly to a Poly.
+ * @pre None.
+ * @post This SparsePoly remains unchanged.
+ * @return A Poly representing the same polynomial as this SparsePoly.
+ */
+Poly SparsePoly::toPoly() const
+{
+    Poly result;
+
+    // start from the terms and let the Poly pick its form
+    result.makeSparse();
+    result.terms = *this;
+    result.adapt();
+
+    return result;
+} // end toPoly()
+
+/**----------------------------------------------------------------------------
+ * Overloaded + operator. Adds this SparsePoly to another and returns the
+ * result.
+ * @param rhs  The SparsePoly to be added to this one.
+ * @pre None.
+ * @post This SparsePoly and rhs remain unchanged.
+ * @return A SparsePoly that is the sum of this one and rhs.
+ */
+SparsePoly SparsePoly::operator+(const SparsePoly& rhs) const
+{
+    SparsePoly sum;
+
+    merge(terms, rhs.terms, false, sum.terms);
+
+    return sum;
+} // end operator+(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded - operator. Subtracts another SparsePoly from this one and
+ * returns the result.
+ * @param rhs  The SparsePoly to be subtracted from this one.
+ * @pre None.
+ * @post This SparsePoly and rhs remain unchanged.
+ * @return A SparsePoly that is the difference between this one and rhs.
+ */
+SparsePoly SparsePoly::operator-(const SparsePoly& rhs) const
+{
+    SparsePoly diff;
+
+    merge(terms, rhs.terms, true, diff.terms);
+
+    return diff;
+} // end operator-(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded * operator. Multiplies this SparsePoly with another one and
+ * returns the result. Every pair of terms is multiplied, then the products
+ * are sorted and like powers combined. A SparsePoly multiplied with itself
+ * pairs each two terms once and doubles the product.
+ * @param rhs  The SparsePoly to be multiplied with this one.
+ * @pre None.
+ * @post This SparsePoly and rhs remain unchanged.
+ * @return A SparsePoly that is the product of this one and rhs, less any
+ *         terms whose power would be above MAX_POWER.
+ */
+SparsePoly SparsePoly::operator*(const SparsePoly& rhs) const
+{
+    SparsePoly prod;
+    vector<Term> all;
+    bool square = &rhs == this;
+
+    all.reserve(square ? terms.size() * (terms.size() + 1) / 2
+                       : terms.size() * rhs.terms.size());
+
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+        // a square takes each pair j > i once, for both orders
+        for (size_t j = square ? i : 0; j < rhs.terms.size(); ++j)
+        {
+            long long exp = static_cast<long long>(terms[i].exp)
+                            + rhs.terms[j].exp;
+
+            // the powers of rhs ascend, so the rest of them are too high
+            if (exp > MAX_POWER)
+            {
+                break;
+            } // end if (exp > MAX_POWER)
+
+            unsigned int coeff = static_cast<unsigned int>(terms[i].coeff);
+
+            coeff *= static_cast<unsigned int>(rhs.terms[j].coeff);
+
+            Term term = { static_cast<int>(exp),
+                          static_cast<int>(square && j != i ? coeff << 1
+                                                            : coeff) };
+            all.push_back(term);
+        } // end for (size_t j = square ? i : 0)
+    } // end for (size_t i = 0)
+
+    sort(all.begin(), all.end(),
+         [](const Term& a, const Term& b) { return a.exp < b.exp; });
+
+    // combine like powers, dropping those that cancel
+    for (size_t i = 0; i < all.size(); )
+    {
+        Term term = all[i];
+        unsigned int coeff = static_cast<unsigned int>(term.coeff);
+
+        for (++i; i < all.size() && all[i].exp == term.exp; ++i)
+        {
+            coeff += static_cast<unsigned int>(all[i].coeff);
+        } // end for (++i)
+
+        if (coeff != 0)
+        {
+            term.coeff = static_cast<int>(coeff);
+            prod.terms.push_back(term);
+        } // end if (coeff != 0)
+    } // end for (size_t i = 0)
+
+    return prod;
+} // end operator*(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded += operator. Adds another SparsePoly to this one.
+ * @param rhs  The SparsePoly to be added to this one.
+ * @pre None.
+ * @post The polynomial value of rhs has been added to this SparsePoly.
+ * @return A reference to this SparsePoly, the sum of the input.
+ */
+SparsePoly& SparsePoly::operator+=(const SparsePoly& rhs)
+{
+    return *this = *this + rhs;
+} // end operator+=(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded -= operator. Subtracts another SparsePoly from this one.
+ * @param rhs  The SparsePoly to be subtracted from this one.
+ * @pre None.
+ * @post The polynomial value of rhs has been subtracted from this SparsePoly.
+ * @return A reference to this SparsePoly, the difference of the input.
+ */
+SparsePoly& SparsePoly::operator-=(const SparsePoly& rhs)
+{
+    return *this = *this - rhs;
+} // end operator-=(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded *= operator. Multiplies another SparsePoly with this one.
+ * @param rhs  The SparsePoly to be multiplied with this one.
+ * @pre None.
+ * @post The polynomial value of rhs has been multiplied with this SparsePoly.
+ * @return A reference to this SparsePoly, the product of the input.
+ */
+SparsePoly& SparsePoly::operator*=(const SparsePoly& rhs)
+{
+    return *this = *this * rhs;
+} // end operator*=(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded == operator. Tests if this SparsePoly represents the same
+ * polynomial as another one.
+ * @param rhs  The SparsePoly to compare with this one.
+ * @pre None.
+ * @post None.
+ * @return true if both have exactly the same terms; false, otherwise.
+ */
+bool SparsePoly::operator==(const SparsePoly& rhs) const
+{
+    if (terms.size() != rhs.terms.size())
+    {
+        return false;
+    } // end if (terms.size() != rhs.terms.size())
+
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+        if (terms[i].exp != rhs.terms[i].exp
+            || terms[i].coeff != rhs.terms[i].coeff)
+        {
+            return false;
+        } // end if (terms[i].exp != rhs.terms[i].exp ...)
+    } // end for (size_t i = 0)
+
+    return true;
+} // end operator==(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded != operator. Tests if this SparsePoly represents a different
+ * polynomial from another one.
+ * @param rhs  The SparsePoly to compare with this one.
+ * @pre None.
+ * @post None.
+ * @return true if the terms of the two differ; false, otherwise.
+ */
+bool SparsePoly::operator!=(const SparsePoly& rhs) const
+{
+    return !(*this == rhs);
+} // end operator!=(const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the coefficient of a power. Found by binary search.
+ * @param exp  The power whose coefficient is sought.
+ * @pre None.
+ * @post This SparsePoly remains unchanged.
+ * @return The coefficient of the indicated power if there is a term for it;
+ *         0, otherwise.
+ */
+int SparsePoly::getCoeff(int exp) const
+{
+    int index = find(exp);
+
+    if (index < static_cast<int>(terms.size()) && terms[index].exp == exp)
+    {
+        return terms[index].coeff;
+    } // end if (index < terms.size() ...)
+
+    return 0;
+} // end getCoeff(int)
+
+/**----------------------------------------------------------------------------
+ * Mutator to set the coefficient of a power.
+ * @param coeff  The new coefficient of the indicated power.
+ * @param exp  The power to set. Only the absolute value of exp is used.
+ * @pre None.
+ * @post This SparsePoly has the identified power set to the specified
+ *       coefficient. The term is added if it was absent and removed if coeff
+ *       is 0. Setting powers in ascending order appends to the end of the term
+ *       list. A power above MAX_POWER cannot be held and leaves this
+ *       SparsePoly unchanged.
+ */
+void SparsePoly::setCoeff(int coeff, int exp)
+{
+    if (exp < -MAX_POWER || exp > MAX_POWER)
+    {
+        return;
+    } // end if (exp < -MAX_POWER || exp > MAX_POWER)
+
+    Term term = { exp < 0 ? -exp : exp, coeff };
+
+    // fast path for terms supplied in ascending order
+    if (terms.empty() || terms.back().exp < term.exp)
+    {
+        if (coeff != 0)
+        {
+            terms.push_back(term);
+        } // end if (coeff != 0)
+
+        return;
+    } // end if (terms.empty() || ...)
+
+    int index = find(term.exp);
+
+    if (terms[index].exp == term.exp)
+    {
+        if (coeff != 0)
+        {
+            terms[index].coeff = coeff;
+        }
+        else
+        {
+            terms.erase(terms.begin() + index);
+        } // end if (coeff != 0)
+    }
+    else if (coeff != 0)
+    {
+        terms.insert(terms.begin() + index, term);
+    } // end if (terms[index].exp == term.exp)
+} // end setCoeff(int, int)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the number of terms.
+ * @pre None.
+ * @post None.
+ * @return The number of terms with a non-zero coefficient.
+ */
+int SparsePoly::termCount() const
+{
+    return static_cast<int>(terms.size());
+} // end termCount()
+
+/**----------------------------------------------------------------------------
+ * Accessor for the largest power.
+ * @pre None.
+ * @post None.
+ * @return The power of the last term, or -1 if there are no terms.
+ */
+int SparsePoly::degree() const
+{
+    return terms.empty() ? -1 : terms.back().exp;
+} // end degree()
+
+/**----------------------------------------------------------------------------
+ * Overloaded << operator. Writes the terms of a SparsePoly to an ostream in
+ * the same format as Poly: from the largest power down, each term preceded by
+ * a space and signed, x shown for powers greater than 0 and x^y for powers
+ * greater than 1. " 0" is written if there are no terms. The terms are
+ * rendered into one buffer and written with a single call.
+ * @param output  The ostream to which to write out the polynomial.
+ * @param source  The SparsePoly to write out.
+ * @pre None.
+ * @post The ostream contains a string representing source.
+ * @return A reference to the supplied ostream.
+ */
+ostream& operator<<(ostream& output, const SparsePoly& source)
+{
+    int count = static_cast<int>(source.terms.size());
+
+    // room for every term, or for " 0"
+    ScratchBuffer buffer(count * (TERM_TEXT_MAX / 4) + 1);
+    char *text = reinterpret_cast<char*>(buffer.data());
+    char *end = text;
+
+    if (count == 0)
+    {
+        *end++ = ' ';
+        *end++ = '0';
+    } // end if (count == 0)
+
+    for (int i = count - 1; i >= 0; --i)
+    {
+        end = formatTerm(end, source.terms[i].coeff, source.terms[i].exp);
+    } // end for (int i = count - 1)
+
+    return output.write(text, end - text);
+} // end operator<<(ostream&, const SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Overloaded >> operator. Reads coefficient and power pairs from the supplied
+ * istream, in the same format as Poly, until a pair of 0 0 is encountered. A
+ * power that appears more than once keeps its last coefficient.
+ * @param input  The istream from which to read the terms.
+ * @param target  The SparsePoly to which to write the terms.
+ * @pre input contains a series of integers, separated by white space, in
+ *      pairs eventually ending in 0 0.
+ * @post The integer pairs up to 0 0 have been removed from the supplied
+ *       istream. target holds exactly the terms that were read.
+ * @return A reference to the supplied istream.
+ */
+istream& operator>>(istream& input, SparsePoly& target)
+{
+    vector<SparsePoly::Term> read;
+    int coeff, exp;
+
+    input >> coeff >> exp;
+
+    while(input && (coeff != 0 || exp != 0))
+    {
+        SparsePoly::Term term = { exp < 0 ? -exp : exp, coeff };
+        read.push_back(term);
+        input >> coeff >> exp;
+    } // end while(input && ...)
+
+    // a stable sort keeps repeated powers in the order they were read
+    stable_sort(read.begin(), read.end(),
+                [](const SparsePoly::Term& a, const SparsePoly::Term& b)
+                { return a.exp < b.exp; });
+    target.terms.clear();
+
+    for (size_t i = 0; i < read.size(); ++i)
+    {
+        bool last = i + 1 == read.size() || read[i + 1].exp != read[i].exp;
+
+        if (last && read[i].coeff != 0)
+        {
+            target.terms.push_back(read[i]);
+        } // end if (last && read[i].coeff != 0)
+    } // end for (size_t i = 0)
+
+    return input;
+} // end operator>>(istream&, SparsePoly&)
+
+/**----------------------------------------------------------------------------
+ * Merges two term lists, adding or subtracting like powers and dropping any
+ * that cancel to 0.
+ * @param lhs  The first term list.
+ * @param rhs  The second term list.
+ * @param subtract  true to subtract rhs from lhs; false to add them.
+ * @param result  The list to receive the merged terms.
+ * @pre result is neither lhs nor rhs.
+ * @post result holds lhs + rhs or lhs - rhs in ascending order.
+ */
+void SparsePoly::merge(const vector<Term>& lhs, const vector<Term>& rhs,
+                       bool subtract, vector<Term>& result)
+{
+    size_t i = 0, j = 0;
+
+    result.clear();
+    result.reserve(lhs.size() + rhs.size());
+
+    while (i < lhs.size() || j < rhs.size())
+    {
+        Term term;
+
+        if (j == rhs.size() || (i < lhs.size() && lhs[i].exp < rhs[j].exp))
+        {
+            term = lhs[i++];
+        }
+        else
+        {
+            unsigned int coeff = static_cast<unsigned int>(rhs[j].coeff);
+
+            term.exp = rhs[j++].exp;
+
+            if (subtract)
+            {
+                coeff = 0u - coeff;
+            } // end if (subtract)
+
+            // like powers in both lists
+            if (i < lhs.size() && lhs[i].exp == term.exp)
+            {
+                coeff += static_cast<unsigned int>(lhs[i++].coeff);
+            } // end if (i < lhs.size() && ...)
+
+            term.coeff = static_cast<int>(coeff);
+        } // end if (j == rhs.size() || ...)
+
+        if (term.coeff != 0)
+        {
+            result.push_back(term);
+        } // end if (term.coeff != 0)
+    } // end while (i < lhs.size() || j < rhs.size())
+} // end merge(const vector<Term>&, const vector<Term>&, bool, ...)
+
+/**----------------------------------------------------------------------------
+ * Finds the position of a power in the term list by binary search.
+ * @param exp  The power to find.
+ * @pre None.
+ * @post None.
+ * @return The index of the first term whose power is not less than exp.
+ */
+int SparsePoly::find(int exp) const
+{
+    int low = 0, high = static_cast<int>(terms.size());
+
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+
+        if (terms[mid].exp < exp)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        } // end if (terms[mid].exp < exp)
+    } // end while (low < high)
+
+    return low;
+} // end find(int)
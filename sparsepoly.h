@@ -0,0 +1,266 @@
+/**
+ * @file    sparsepoly.h
+ * @brief   This class represents a polynomial as a list of terms, each an
+ *          exponent paired with a non-zero coefficient, kept in ascending
+ *          order of exponent. Unlike Poly, whose storage grows with its
+ *          largest power, a SparsePoly only stores the terms that are
+ *          present, so +50x^20000 +50 takes two terms instead of 20001
+ *          elements. Arithmetic, comparison and stream I/O all run in time
+ *          proportional to the number of terms. It offers the same interface
+ *          as Poly, including the same text format for iostreams, and can be
+ *          converted to and from a Poly.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _SPARSEPOLY_H
+#define	_SPARSEPOLY_H
+
+#include <climits>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+class Poly;
+
+class SparsePoly
+{
+public:
+
+    // largest power a term may have, so that one more than it fits in an int
+    static const int MAX_POWER = INT_MAX - 1;
+
+    /**------------------------------------------------------------------------
+     * Default constructor. Creates a SparsePoly with no terms, which
+     * represents 0.
+     * @pre None.
+     * @post SparsePoly has no terms.
+     */
+    SparsePoly();
+
+    /**------------------------------------------------------------------------
+     * Single parameter constructor. Creates a SparsePoly with an x^0 term of
+     * a specified coefficient.
+     * @param coeff  The coefficient of the x^0 term.
+     * @pre None.
+     * @post SparsePoly has a single x^0 term equal to coeff, or no terms if
+     *       coeff is 0.
+     */
+    SparsePoly(int coeff);
+
+    /**------------------------------------------------------------------------
+     * Double parameter constructor. Creates a SparsePoly with a single term.
+     * @param coeff  The coefficient of the term.
+     * @param exp  The power of the term. Only the absolute value of exp is
+     *             used.
+     * @pre None.
+     * @post SparsePoly has a single term coeff x^exp, or no terms if coeff
+     *       is 0 or exp is above MAX_POWER.
+     */
+    SparsePoly(int coeff, int exp);
+
+    /**------------------------------------------------------------------------
+     * Conversion constructor. Creates a SparsePoly holding the non-zero
+     * elements of a Poly.
+     * @param dense  The Poly to convert.
+     * @pre None.
+     * @post SparsePoly represents the same polynomial as dense.
+     */
+    explicit SparsePoly(const Poly& dense);
+
+    /**------------------------------------------------------------------------
+     * Converts this SparsePoly to a Poly.
+     * @pre None.
+     * @post This SparsePoly remains unchanged.
+     * @return A Poly representing the same polynomial as this SparsePoly.
+     */
+    Poly toPoly() const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded + operator. Adds this SparsePoly to another and returns the
+     * result.
+     * @param rhs  The SparsePoly to be added to this one.
+     * @pre None.
+     * @post This SparsePoly and rhs remain unchanged.
+     * @return A SparsePoly that is the sum of this one and rhs.
+     */
+    SparsePoly operator+(const SparsePoly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded - operator. Subtracts another SparsePoly from this one and
+     * returns the result.
+     * @param rhs  The SparsePoly to be subtracted from this one.
+     * @pre None.
+     * @post This SparsePoly and rhs remain unchanged.
+     * @return A SparsePoly that is the difference between this one and rhs.
+     */
+    SparsePoly operator-(const SparsePoly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded * operator. Multiplies this SparsePoly with another one and
+     * returns the result. Every pair of terms is multiplied, then the
+     * products are sorted and like powers combined. A SparsePoly multiplied
+     * with itself pairs each two terms once and doubles the product.
+     * @param rhs  The SparsePoly to be multiplied with this one.
+     * @pre None.
+     * @post This SparsePoly and rhs remain unchanged.
+     * @return A SparsePoly that is the product of this one and rhs, less any
+     *         terms whose power would be above MAX_POWER.
+     */
+    SparsePoly operator*(const SparsePoly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded += operator. Adds another SparsePoly to this one.
+     * @param rhs  The SparsePoly to be added to this one.
+     * @pre None.
+     * @post The polynomial value of rhs has been added to this SparsePoly.
+     * @return A reference to this SparsePoly, the sum of the input.
+     */
+    SparsePoly& operator+=(const SparsePoly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Overloaded -= operator. Subtracts another SparsePoly from this one.
+     * @param rhs  The SparsePoly to be subtracted from this one.
+     * @pre None.
+     * @post The polynomial value of rhs has been subtracted from this
+     *       SparsePoly.
+     * @return A reference to this SparsePoly, the difference of the input.
+     */
+    SparsePoly& operator-=(const SparsePoly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Overloaded *= operator. Multiplies another SparsePoly with this one.
+     * @param rhs  The SparsePoly to be multiplied with this one.
+     * @pre None.
+     * @post The polynomial value of rhs has been multiplied with this
+     *       SparsePoly.
+     * @return A reference to this SparsePoly, the product of the input.
+     */
+    SparsePoly& operator*=(const SparsePoly& rhs);
+
+    /**------------------------------------------------------------------------
+     * Overloaded == operator. Tests if this SparsePoly represents the same
+     * polynomial as another one.
+     * @param rhs  The SparsePoly to compare with this one.
+     * @pre None.
+     * @post None.
+     * @return true if both have exactly the same terms; false, otherwise.
+     */
+    bool operator==(const SparsePoly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded != operator. Tests if this SparsePoly represents a different
+     * polynomial from another one.
+     * @param rhs  The SparsePoly to compare with this one.
+     * @pre None.
+     * @post None.
+     * @return true if the terms of the two differ; false, otherwise.
+     */
+    bool operator!=(const SparsePoly& rhs) const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for the coefficient of a power. Found by binary search.
+     * @param exp  The power whose coefficient is sought.
+     * @pre None.
+     * @post This SparsePoly remains unchanged.
+     * @return The coefficient of the indicated power if there is a term for
+     *         it; 0, otherwise.
+     */
+    int getCoeff(int exp) const;
+
+    /**------------------------------------------------------------------------
+     * Mutator to set the coefficient of a power.
+     * @param coeff  The new coefficient of the indicated power.
+     * @param exp  The power to set. Only the absolute value of exp is used.
+     * @pre None.
+     * @post This SparsePoly has the identified power set to the specified
+     *       coefficient. The term is added if it was absent and removed if
+     *       coeff is 0. Setting powers in ascending order appends to the end
+     *       of the term list. A power above MAX_POWER cannot be held and
+     *       leaves this SparsePoly unchanged.
+     */
+    void setCoeff(int coeff, int exp);
+
+    /**------------------------------------------------------------------------
+     * Accessor for the number of terms.
+     * @pre None.
+     * @post None.
+     * @return The number of terms with a non-zero coefficient.
+     */
+    int termCount() const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for the largest power.
+     * @pre None.
+     * @post None.
+     * @return The power of the last term, or -1 if there are no terms.
+     */
+    int degree() const;
+
+    /**------------------------------------------------------------------------
+     * Overloaded << operator. Writes the terms of a SparsePoly to an ostream
+     * in the same format as Poly: from the largest power down, each term
+     * preceded by a space and signed, x shown for powers greater than 0 and
+     * x^y for powers greater than 1. " 0" is written if there are no terms.
+     * The terms are rendered into one buffer and written with a single call.
+     * @param output  The ostream to which to write out the polynomial.
+     * @param source  The SparsePoly to write out.
+     * @pre None.
+     * @post The ostream contains a string representing source.
+     * @return A reference to the supplied ostream.
+     */
+    friend ostream& operator<<(ostream&, const SparsePoly&);
+
+    /**------------------------------------------------------------------------
+     * Overloaded >> operator. Reads coefficient and power pairs from the
+     * supplied istream, in the same format as Poly, until a pair of 0 0 is
+     * encountered. A power that appears more than once keeps its last
+     * coefficient.
+     * @param input  The istream from which to read the terms.
+     * @param target  The SparsePoly to which to write the terms.
+     * @pre input contains a series of integers, separated by white space, in
+     *      pairs eventually ending in 0 0.
+     * @post The integer pairs up to 0 0 have been removed from the supplied
+     *       istream. target holds exactly the terms that were read.
+     * @return A reference to the supplied istream.
+     */
+    friend istream& operator>>(istream&, SparsePoly&);
+
+private:
+
+    // a Poly in the sparse form works on the term list directly
+    friend class Poly;
+
+    struct Term
+    {
+        int exp;
+        int coeff;
+    };
+
+    /**------------------------------------------------------------------------
+     * Merges two term lists, adding or subtracting like powers and dropping
+     * any that cancel to 0.
+     * @param lhs  The first term list.
+     * @param rhs  The second term list.
+     * @param subtract  true to subtract rhs from lhs; false to add them.
+     * @param result  The list to receive the merged terms.
+     * @pre result is neither lhs nor rhs.
+     * @post result holds lhs + rhs or lhs - rhs in ascending order.
+     */
+    static void merge(const vector<Term>& lhs, const vector<Term>& rhs,
+                      bool subtract, vector<Term>& result);
+
+    /**------------------------------------------------------------------------
+     * Finds the position of a power in the term list by binary search.
+     * @param exp  The power to find.
+     * @pre None.
+     * @post None.
+     * @return The index of the first term whose power is not less than exp.
+     */
+    int find(int exp) const;
+
+    vector<Term> terms;     // ascending powers, non-zero coefficients
+};
+
+#endif	/* _SPARSEPOLY_H */
@@ -0,0 +1,188 @@
+/**
+ * @file    threadpool.cpp
+ * @brief   A fixed set of worker threads for splitting the arithmetic
+ *          kernels behind Poly across cores. run() hands out the indices of
+ *          a batch of tasks to the workers and to the calling thread, and
+ *          returns once every task has finished. A task that calls run()
+ *          again, or a second thread that calls run() while a batch is in
+ *          progress, simply runs its tasks itself, so kernels can use the
+ *          pool without worrying about who else does.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#include "threadpool.h"
+#include <cstddef>
+
+// true while the current thread is running a task of some pool
+static thread_local bool inTask = false;
+
+/**----------------------------------------------------------------------------
+ * Constructor. Starts the worker threads.
+ * @param threads  The number of threads to run tasks on, counting the one
+ *                 that calls run(). Values below 1 are treated as 1.
+ * @pre None.
+ * @post threads - 1 workers are waiting for tasks.
+ */
+ThreadPool::ThreadPool(int threads) : task(NULL), context(NULL), count(0),
+                                      next(0), pending(0), generation(0),
+                                      stopping(false)
+{
+    for (int i = 1; i < threads; ++i)
+    {
+        workers.push_back(thread(&ThreadPool::work, this));
+    } // end for (int i = 1)
+} // end Constructor
+
+/**----------------------------------------------------------------------------
+ * Destructor. Stops and joins the worker threads.
+ * @pre No call to run() is in progress.
+ * @post All worker threads have ended.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        unique_lock<mutex> guard(lock);
+
+        stopping = true;
+        started.notify_all();
+    }
+
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        workers[i].join();
+    } // end for (size_t i = 0)
+} // end Destructor
+
+/**----------------------------------------------------------------------------
+ * Runs a batch of tasks, spread over the workers and the calling thread.
+ * Without workers, for a single task, inside a task or while another
+ * batch runs, the calling thread runs them all alone; runningTask() is
+ * true for them either way, so kernels they call stay on their thread.
+ * @param count  The number of tasks; task is called with each index from 0
+ *               to count - 1.
+ * @param task  The function to run.
+ * @param context  Passed to every call of task.
+ * @pre Tasks with different indices may run at the same time.
+ * @post Every task has returned.
+ */
+void ThreadPool::run(int count, Task task, void *context)
+{
+    // nested or concurrent batches run on the calling thread alone
+    if (workers.empty() || count < 2 || inTask || !batch.try_lock())
+    {
+        // the tasks are still in a pool, so batches they start stay here too
+        bool outer = inTask;
+
+        inTask = true;
+
+        for (int i = 0; i < count; ++i)
+        {
+            task(context, i);
+        } // end for (int i = 0)
+
+        inTask = outer;
+        return;
+    } // end if (workers.empty() || ...)
+
+    unique_lock<mutex> guard(lock);
+
+    this->task = task;
+    this->context = context;
+    this->count = count;
+    next = 0;
+    pending = count;
+    ++generation;
+    started.notify_all();
+    drain(guard);
+
+    while (pending > 0)
+    {
+        finished.wait(guard);
+    } // end while (pending > 0)
+
+    guard.unlock();
+    batch.unlock();
+} // end run(int, Task, void*)
+
+/**----------------------------------------------------------------------------
+ * Accessor for the number of threads tasks run on.
+ * @pre None.
+ * @post None.
+ * @return The number of workers plus one for the calling thread.
+ */
+int ThreadPool::size() const
+{
+    return static_cast<int>(workers.size()) + 1;
+} // end size()
+
+/**----------------------------------------------------------------------------
+ * Accessor for whether the calling thread is running a task.
+ * @pre None.
+ * @post None.
+ * @return true if the calling thread is inside a task of some pool; false,
+ *         otherwise.
+ */
+bool ThreadPool::runningTask()
+{
+    return inTask;
+} // end runningTask()
+
+/**----------------------------------------------------------------------------
+ * The loop each worker runs: waits for a batch, helps finish it, and repeats
+ * until the pool is destroyed.
+ * @pre None.
+ * @post The pool is stopping.
+ */
+void ThreadPool::work()
+{
+    unique_lock<mutex> guard(lock);
+    unsigned long seen = generation;
+
+    while (true)
+    {
+        while (!stopping && (generation == seen || next >= count))
+        {
+            started.wait(guard);
+        } // end while (!stopping && ...)
+
+        if (stopping)
+        {
+            return;
+        } // end if (stopping)
+
+        seen = generation;
+        drain(guard);
+    } // end while (true)
+} // end work()
+
+/**----------------------------------------------------------------------------
+ * Runs tasks of the current batch until none are left to start.
+ * @param guard  The lock on the pool's mutex.
+ * @pre guard holds the mutex and a batch is in progress.
+ * @post Every task of the batch has been started; guard holds the mutex.
+ */
+void ThreadPool::drain(unique_lock<mutex>& guard)
+{
+    bool outer = inTask;
+
+    inTask = true;
+
+    while (next < count)
+    {
+        int index = next++;
+        Task current = task;
+        void *argument = context;
+
+        guard.unlock();
+        current(argument, index);
+        guard.lock();
+
+        if (--pending == 0)
+        {
+            finished.notify_all();
+        } // end if (--pending == 0)
+    } // end while (next < count)
+
+    inTask = outer;
+} // end drain(unique_lock<mutex>&)
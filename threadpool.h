@@ -0,0 +1,117 @@
+/**
+ * @file    threadpool.h
+ * @brief   A fixed set of worker threads for splitting the arithmetic
+ *          kernels behind Poly across cores. run() hands out the indices of
+ *          a batch of tasks to the workers and to the calling thread, and
+ *          returns once every task has finished. A task that calls run()
+ *          again, or a second thread that calls run() while a batch is in
+ *          progress, simply runs its tasks itself, so kernels can use the
+ *          pool without worrying about who else does.
+ * @author  Brendan Sweeney, SID 1161837
+ * @date    October 16, 2026
+ */
+
+#ifndef _THREADPOOL_H
+#define	_THREADPOOL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool
+{
+public:
+
+    // a task: the context passed to run() and the index of the task
+    typedef void (*Task)(void *context, int index);
+
+    /**------------------------------------------------------------------------
+     * Constructor. Starts the worker threads.
+     * @param threads  The number of threads to run tasks on, counting the
+     *                 one that calls run(). Values below 1 are treated as 1.
+     * @pre None.
+     * @post threads - 1 workers are waiting for tasks.
+     */
+    explicit ThreadPool(int threads);
+
+    /**------------------------------------------------------------------------
+     * Destructor. Stops and joins the worker threads.
+     * @pre No call to run() is in progress.
+     * @post All worker threads have ended.
+     */
+    ~ThreadPool();
+
+    /**------------------------------------------------------------------------
+     * Runs a batch of tasks, spread over the workers and the calling thread.
+     * Without workers, for a single task, inside a task or while another
+     * batch runs, the calling thread runs them all alone; runningTask() is
+     * true for them either way, so kernels they call stay on their thread.
+     * @param count  The number of tasks; task is called with each index from
+     *               0 to count - 1.
+     * @param task  The function to run.
+     * @param context  Passed to every call of task.
+     * @pre Tasks with different indices may run at the same time.
+     * @post Every task has returned.
+     */
+    void run(int count, Task task, void *context);
+
+    /**------------------------------------------------------------------------
+     * Accessor for the number of threads tasks run on.
+     * @pre None.
+     * @post None.
+     * @return The number of workers plus one for the calling thread.
+     */
+    int size() const;
+
+    /**------------------------------------------------------------------------
+     * Accessor for whether the calling thread is running a task. A kernel
+     * can check this to avoid splitting work that is already one of many
+     * tasks.
+     * @pre None.
+     * @post None.
+     * @return true if the calling thread is inside a task of some pool;
+     *         false, otherwise.
+     */
+    static bool runningTask();
+
+private:
+
+    // a pool is tied to its threads, so it cannot be copied
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    /**------------------------------------------------------------------------
+     * The loop each worker runs: waits for a batch, helps finish it, and
+     * repeats until the pool is destroyed.
+     * @pre None.
+     * @post The pool is stopping.
+     */
+    void work();
+
+    /**------------------------------------------------------------------------
+     * Runs tasks of the current batch until none are left to start.
+     * @param guard  The lock on the pool's mutex.
+     * @pre guard holds the mutex and a batch is in progress.
+     * @post Every task of the batch has been started; guard holds the
+     *       mutex.
+     */
+    void drain(unique_lock<mutex>& guard);
+
+    vector<thread> workers;
+    mutex lock;                     // guards everything below
+    mutex batch;                    // held by the thread running a batch
+    condition_variable started;     // a batch was posted, or stopping
+    condition_variable finished;    // the last task of a batch returned
+    Task task;                      // the current batch
+    void *context;
+    int count;
+    int next;                       // index of the next task to start
+    int pending;                    // tasks started or waiting, not done
+    unsigned long generation;       // batches posted so far
+    bool stopping;
+};
+
+#endif	/* _THREADPOOL_H */